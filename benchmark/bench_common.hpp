@@ -0,0 +1,53 @@
+#ifndef HELLOFITTY_BENCH_COMMON_H
+#define HELLOFITTY_BENCH_COMMON_H
+
+#include "hellofitty.hpp"
+
+#include <TH1.h>
+
+#include <fmt/core.h>
+
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace bench
+{
+
+constexpr auto line_v1 = " hist_1 gaus(0) expo(3) 0 0 10  1000 : 0 2000  5 F 4 6  0.5  1  -0.5";
+constexpr auto line_v2 = " hist_1\t0 10 0 gaus(0) expo(3) |  1000 : 0 2000  5 F 4 6  0.5  1  -0.5";
+
+/// Name of the n-th generated entry
+inline auto entry_name(long n) -> std::string { return fmt::format("hist_{:d}", n); }
+
+/// Write parameter file with given number of v2 lines
+inline auto write_parameters_file(const std::string& filename, long lines) -> void
+{
+    std::ofstream file(filename);
+    for (long i = 0; i < lines; ++i)
+    {
+        file << fmt::format(" {:s}\t0 10 0 gaus(0) expo(3) |  {:d} : 0 2000  5 F 4 6  0.5  1  -0.5\n", entry_name(i),
+                            1000 + i % 100);
+    }
+}
+
+/// Create histogram of gaussian peak over exponential background, not registered in gDirectory
+inline auto make_histogram(const std::string& name, int bins) -> std::unique_ptr<TH1D>
+{
+    TH1::AddDirectory(false);
+    auto hist = std::make_unique<TH1D>(name.c_str(), "", bins, 0, 10);
+    for (int i = 1; i <= bins; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(10000. / bins * (50 * std::exp(-0.5 * (x - 5) * (x - 5) / 0.25) +
+                                                         std::exp(1 - 0.5 * x)));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+
+} // namespace bench
+
+#endif /* HELLOFITTY_BENCH_COMMON_H */
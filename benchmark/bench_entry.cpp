@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+
+#include "hellofitty.hpp"
+
+#include "bench_common.hpp"
+
+static void BM_EntryCopy(benchmark::State& state)
+{
+    const auto entry = hf::tools::parse_line_entry(bench::line_v2, hf::format_version::v2);
+    for (auto _ : state)
+    {
+        hf::entry copy(entry.second);
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_EntryCopy);
+
+static void BM_EntryAddFunction(benchmark::State& state)
+{
+    const auto functions = state.range(0);
+    for (auto _ : state)
+    {
+        hf::entry entry(0, 10);
+        for (long i = 0; i < functions; ++i)
+        {
+            entry.add_function(fmt::format("gaus({:d})", 3 * i));
+        }
+        benchmark::DoNotOptimize(entry);
+    }
+}
+BENCHMARK(BM_EntryAddFunction)->Arg(1)->Arg(2)->Arg(4);
+
+static void BM_EntryCompile(benchmark::State& state)
+{
+    hf::entry entry(0, 10);
+    entry.add_function("gaus(0)");
+    for (auto _ : state)
+    {
+        // the total function is recompiled each time a function is added
+        hf::entry copy(entry);
+        copy.add_function("expo(3)");
+        auto* function = &copy.get_function_object();
+        benchmark::DoNotOptimize(function);
+    }
+}
+BENCHMARK(BM_EntryCompile);
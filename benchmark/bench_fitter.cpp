@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_config.h"
+
+#include "bench_common.hpp"
+
+#include <fmt/core.h>
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+auto input_file(long lines) -> std::string { return fmt::format("{:s}bench_input_{:d}.txt", build_path, lines); }
+auto output_file(long lines) -> std::string { return fmt::format("{:s}bench_output_{:d}.txt", build_path, lines); }
+} // namespace
+
+static void BM_FindFit(benchmark::State& state)
+{
+    const auto entries = state.range(0);
+
+    // imported at once, the registry is copied on each single insertion
+    const auto filename = input_file(entries);
+    bench::write_parameters_file(filename, entries);
+
+    hf::fitter fitter;
+    fitter.init_from_file(filename);
+    std::remove(filename.c_str());
+
+    const auto name = bench::entry_name(entries / 2);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(fitter.find_fit(name.c_str()));
+    }
+}
+BENCHMARK(BM_FindFit)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+static void BM_FindFitConcurrent(benchmark::State& state)
+{
+    // shared by all threads, set up by the first one before the timed loop which starts them together
+    static std::unique_ptr<hf::fitter> fitter;
+    constexpr long entries = 1 << 14;
+
+    if (state.thread_index() == 0)
+    {
+        const auto filename = input_file(entries);
+        bench::write_parameters_file(filename, entries);
+        fitter = std::make_unique<hf::fitter>();
+        fitter->init_from_file(filename);
+        std::remove(filename.c_str());
+    }
+
+    const auto name = bench::entry_name(state.thread_index() % entries);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(fitter->find_fit(name.c_str()));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) { fitter.reset(); }
+}
+BENCHMARK(BM_FindFitConcurrent)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_InitFromFile(benchmark::State& state)
+{
+    const auto lines = state.range(0);
+    const auto filename = input_file(lines);
+    bench::write_parameters_file(filename, lines);
+
+    for (auto _ : state)
+    {
+        hf::fitter fitter;
+        benchmark::DoNotOptimize(fitter.init_from_file(filename));
+    }
+
+    state.SetItemsProcessed(state.iterations() * lines);
+    std::remove(filename.c_str());
+}
+BENCHMARK(BM_InitFromFile)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_ExportToFile(benchmark::State& state)
+{
+    const auto lines = state.range(0);
+    const auto filename = input_file(lines);
+    const auto auxname = output_file(lines);
+    bench::write_parameters_file(filename, lines);
+
+    hf::fitter fitter;
+    fitter.init_from_file(filename, auxname, hf::fitter::priority_mode::reference);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(fitter.export_to_file());
+    }
+
+    state.SetItemsProcessed(state.iterations() * lines);
+    std::remove(filename.c_str());
+    std::remove(auxname.c_str());
+}
+BENCHMARK(BM_ExportToFile)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_Fit(benchmark::State& state)
+{
+    const auto bins = static_cast<int>(state.range(0));
+    const auto engine = static_cast<hf::fitter::fit_engine>(state.range(1));
+
+    hf::fitter fitter;
+    fitter.set_verbose(false);
+    fitter.set_fit_engine(engine);
+
+    const auto entry = hf::tools::parse_line_entry(" h 0 10 0 gaus(0) expo(3) | 400 4.8 0.6 1 -0.5");
+    auto hist = bench::make_histogram("h", bins);
+
+    for (auto _ : state)
+    {
+        auto hfp = entry.second;
+        benchmark::DoNotOptimize(fitter.fit(&hfp, hist.get()));
+    }
+}
+
+static const std::vector<int64_t> engines{static_cast<int64_t>(hf::fitter::fit_engine::root),
+                                          static_cast<int64_t>(hf::fitter::fit_engine::native)};
+
+BENCHMARK(BM_Fit)
+    ->ArgsProduct({{100, 1000, 10000}, engines})
+    ->ArgNames({"bins", "engine"})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_FitGeneric(benchmark::State& state)
+{
+    hf::fitter fitter;
+    fitter.set_verbose(false);
+    fitter.set_generic_entry(hf::tools::parse_line_entry(" h 0 10 0 gaus(0) expo(3) | 400 4.8 0.6 1 -0.5").second);
+
+    auto hist = bench::make_histogram("h_generic", 100);
+
+    for (auto _ : state)
+    {
+        fitter.clear();
+        benchmark::DoNotOptimize(fitter.fit(hist.get()));
+    }
+}
+BENCHMARK(BM_FitGeneric)->Unit(benchmark::kMicrosecond);
+
+static void BM_FitSeeded(benchmark::State& state)
+{
+    const auto seed = state.range(0) != 0;
+
+    hf::fitter fitter;
+    fitter.set_verbose(false);
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+
+    // poor starting point, away from the peak at 5
+    auto entry = hf::tools::parse_line_entry(" h 0 10 0 gaus(0) expo(3) | 100 8 1 0 0");
+    entry.second.set_auto_seed(seed);
+    auto hist = bench::make_histogram("h_seeded", 1000);
+
+    int64_t fits = 0;
+    int64_t converged = 0;
+    for (auto _ : state)
+    {
+        auto hfp = entry.second;
+        const auto fitted = fitter.fit(&hfp, hist.get()) and hfp.get_fit_result().is_valid();
+        converged += fitted and std::abs(hfp.param(1).value - 5) < 0.05;
+        ++fits;
+    }
+
+    state.counters["converged"] = benchmark::Counter(static_cast<double>(converged) / static_cast<double>(fits));
+}
+BENCHMARK(BM_FitSeeded)->Arg(0)->Arg(1)->ArgNames({"seed"})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+
+#include "hellofitty.hpp"
+
+#include "bench_common.hpp"
+
+static void BM_ParseLineV1(benchmark::State& state)
+{
+    const std::string line = bench::line_v1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hf::tools::parse_line_entry(line, hf::format_version::v1));
+    }
+}
+BENCHMARK(BM_ParseLineV1);
+
+static void BM_ParseLineV2(benchmark::State& state)
+{
+    const std::string line = bench::line_v2;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hf::tools::parse_line_entry(line, hf::format_version::v2));
+    }
+}
+BENCHMARK(BM_ParseLineV2);
+
+static void BM_ParseLineDetect(benchmark::State& state)
+{
+    const std::string line = bench::line_v2;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hf::tools::parse_line_entry(line));
+    }
+}
+BENCHMARK(BM_ParseLineDetect);
+
+static void BM_FormatLineV1(benchmark::State& state)
+{
+    const auto entry = hf::tools::parse_line_entry(bench::line_v1, hf::format_version::v1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hf::tools::format_line_entry(entry.first, &entry.second, hf::format_version::v1));
+    }
+}
+BENCHMARK(BM_FormatLineV1);
+
+static void BM_FormatLineV2(benchmark::State& state)
+{
+    const auto entry = hf::tools::parse_line_entry(bench::line_v2, hf::format_version::v2);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hf::tools::format_line_entry(entry.first, &entry.second, hf::format_version::v2));
+    }
+}
+BENCHMARK(BM_FormatLineV2);
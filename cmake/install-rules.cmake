@@ -20,8 +20,13 @@ install(
     COMPONENT HelloFitty_Development
 )
 
+set(install_targets HelloFitty)
+if(TARGET HelloFittyClient)
+  list(APPEND install_targets HelloFittyClient)
+endif()
+
 install(
-    TARGETS HelloFitty
+    TARGETS ${install_targets}
     EXPORT HelloFittyTargets
     RUNTIME #
     COMPONENT HelloFitty_Runtime
@@ -0,0 +1,81 @@
+#ifndef HELLOFITTY_CHECKPOINT_H
+#define HELLOFITTY_CHECKPOINT_H
+
+#include "hellofitty.hpp"
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace hf::detail
+{
+
+/// Journal of the completed fits, see fitter::set_checkpoint(). Each record is a single line: '+' or '-' for the fit
+/// status followed by the entry in the v2 format. Records are appended and written to the file every interval records,
+/// so a killed process loses at most the unwritten records. A torn last line is ignored on load.
+class checkpoint final
+{
+public:
+    /// Record of a completed fit.
+    struct record
+    {
+        bool status;      ///< fit status
+        std::string line; ///< entry in the v2 format
+    };
+
+    /// @param filename journal file, created if missing, never truncated
+    /// @param interval records kept in memory before writing, 1 writes each record at once
+    checkpoint(std::string filename, int interval);
+    checkpoint(const checkpoint&) = delete;
+    auto operator=(const checkpoint&) -> checkpoint& = delete;
+    /// Writes the pending records.
+    ~checkpoint();
+
+    auto get_filename() const -> const std::string& { return filename; }
+
+    /// Append the record of the completed fit.
+    /// @param name data object name
+    /// @param status fit status
+    /// @param hfp fitted entry
+    /// @throw std::runtime_error if the records cannot be written, they are kept for the next write
+    auto add(const std::string& name, bool status, const entry* hfp) -> void;
+
+    /// Write the pending records to the file.
+    /// @throw std::runtime_error if the records cannot be written, they are kept for the next write
+    auto flush() -> void;
+
+    /// Read the journal, keeping the last record of each name, and rewrite it compacted. The journal stays open for
+    /// the next records also if the compaction fails.
+    /// @return the loaded records by data object name
+    /// @throw std::runtime_error if the compacted journal cannot be written
+    auto load() -> std::map<std::string, record>;
+
+    /// Mark the fit as completed, so that it is skipped.
+    /// @param name data object name
+    /// @param status fit status
+    auto set_completed(const std::string& name, bool status) -> void;
+
+    /// Get the status of the fit marked as completed.
+    /// @param name data object name
+    /// @return the fit status, empty if the fit is not completed
+    auto completed(const std::string& name) const -> std::optional<bool>;
+
+private:
+    auto open() -> void;
+    auto write_pending() -> void; // requires mutex, throws std::runtime_error if the file cannot be written
+
+    const std::string filename;
+    const int interval;
+
+    mutable std::mutex mutex;
+    std::ofstream file;
+    std::string pending; // records not written yet
+    int pending_count{0};
+    std::map<std::string, bool> done; // fits completed by the previous runs
+};
+
+} // namespace hf::detail
+
+#endif /* HELLOFITTY_CHECKPOINT_H */
@@ -1,14 +1,26 @@
 #ifndef HELLOFITTY_DETAILS_H
 #define HELLOFITTY_DETAILS_H
 
+#include "checkpoint.hpp"
+#include "logger.hpp"
+#include "objective.hpp"
+#include "registry.hpp"
+#include "trace.hpp"
+#include "watcher.hpp"
+
 #include <TF1.h>
+#include <TFitResult.h>
 
 #include <fmt/color.h>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <unordered_map>
+#include <unordered_set>
 
 #if __cplusplus < 201402L
 template <typename T, typename... Args> std::unique_ptr<T> make_unique(Args&&... args)
@@ -60,6 +72,53 @@ struct draw_opts_impl final
 #endif
 };
 
+/// Compiled formulas by their body, so that the entries sharing a formula compile it once. The stored functions are
+/// never modified, their copies are handed out.
+class formula_cache final
+{
+public:
+    /// Copy of the compiled formula, compiled and stored on the first request.
+    /// @param body formula
+    /// @param range_min lower range of the copy
+    /// @param range_max upper range of the copy
+    /// @return the function
+    auto get(const std::string& body, Double_t range_min, Double_t range_max) -> TF1;
+
+    /// Drop the formulas which are not in the set.
+    /// @param bodies formulas to keep
+    auto retain(const std::unordered_set<std::string>& bodies) -> void;
+
+    auto size() const -> size_t { return formulas.size(); }
+
+private:
+    std::unordered_map<std::string, TF1> formulas;
+};
+
+/// Formula cache of the import currently running on this thread, see formula_cache_activation.
+/// @return the cache or nullptr
+auto current_formula_cache() -> formula_cache*;
+
+/// Makes the cache current on this thread for the lifetime of the object, the previous one is restored on
+/// destruction.
+class formula_cache_activation final
+{
+public:
+    explicit formula_cache_activation(formula_cache* cache);
+    formula_cache_activation(const formula_cache_activation&) = delete;
+    auto operator=(const formula_cache_activation&) -> formula_cache_activation& = delete;
+    ~formula_cache_activation();
+
+private:
+    formula_cache* previous;
+};
+
+/// Compile the formula, or copy it from the current formula cache if there is one.
+/// @param body formula
+/// @param range_min lower range
+/// @param range_max upper range
+/// @return the function
+auto make_formula(const std::string& body, Double_t range_min, Double_t range_max) -> TF1;
+
 /// Structure stores a set of values for a single function parameters like the the mean value,
 /// lwoer or upper boundaries, free or fixed fitting mode.
 struct function_impl final
@@ -72,7 +131,7 @@ struct function_impl final
     /// @param par_mode parameter fitting mode, see @ref fit_mode
     explicit function_impl(std::string body, Double_t range_min, Double_t range_max)
     {
-        function_obj = TF1("", body.c_str(), range_min, range_max, TF1::EAddToList::kNo);
+        function_obj = make_formula(body, range_min, range_max);
         body_string = std::move(body);
     }
 
@@ -84,14 +143,44 @@ struct function_impl final
     }
 };
 
+/// Histogram state at the last fit of fitter::fit_online().
+struct online_state
+{
+    bool fitted{false};     // fitted at least once
+    bool accepted{false};   // the last fit was successful and accepted
+    Double_t entries{0.0};  // histogram entries
+    Double_t integral{0.0}; // integral in the fit range
+};
+
+/// Lock of the entry, held by the fits, so the fits of the same entry on different threads take turns. Readers never
+/// take it. Recursive, so that the fitter may lock the entry around the nested fit calls. It is not copied with the
+/// entry.
+struct entry_lock final
+{
+    entry_lock() = default;
+    entry_lock(const entry_lock& /*other*/) {}
+    auto operator=(const entry_lock& /*other*/) -> entry_lock& { return *this; }
+
+    std::recursive_mutex mutex;
+};
+
 struct entry_impl
 {
+    entry_lock lock;
+
     Double_t range_min; // function range mix
     Double_t range_max; // function range max
 
     int rebin{0}; // rebin, 0 == no rebin
     bool fit_disabled{false};
 
+    minimizer_opts minimizer;
+    fit_budget budget;
+    bool budget_exceeded{false}; // last fit was aborted
+    bool auto_seed{false};       // seed parameters from the data before fit
+    fit_result result;           // outcome of the last fit
+    online_state online;         // histogram state at the last online fit
+
     std::vector<function_impl> funcs;
     std::string complete_function_body;
     TF1 complete_function_object;
@@ -117,7 +206,7 @@ struct entry_impl
                                                  [](std::string a, hf::detail::function_impl b)
                                                  { return std::move(a) + "+" + b.body_string; });
 
-        complete_function_object = TF1("", complete_function_body.c_str(), range_min, range_max, TF1::EAddToList::kNo);
+        complete_function_object = make_formula(complete_function_body, range_min, range_max);
 
         auto npars = int2size_t(complete_function_object.GetNpar());
         pars.resize(npars);
@@ -165,84 +254,346 @@ struct entry_impl
     }
 };
 
+/// Estimate initial values of gaus(N) and expo(N) components from the data: exponential slope from the range edges,
+/// peaks height, mean and sigma from the greedy half-maximum search. Fixed parameters are not touched and limits are
+/// respected. The seeds are accepted only if they give lower chi2 than the current values.
+/// @param hfp entry to be seeded
+/// @param data data snapshot, empty bins included
+/// @return number of seeded parameters, 0 if the seeds were rejected
+auto seed_parameters(entry_impl& hfp, const bin_data& data) -> int;
+
+/// Heap memory used by the string.
+auto memory_of(const std::string& str) -> size_t;
+
+/// Estimate memory used by the entry, see hf::memory_usage.
+/// @param hfp the entry
+/// @return memory breakdown
+auto memory_of(const entry_impl& hfp) -> memory_usage;
+
+/// Accumulates the wall-clock time of consecutive fit phases into the record, and records each phase as a trace span
+/// if the tracer is given. Does nothing without the record.
+class phase_timer final
+{
+public:
+    phase_timer(fit_record* rec, tracer* trc, const char* entry_name) : record(rec), trace(trc), name(entry_name)
+    {
+        if (record) { last = std::chrono::steady_clock::now(); }
+    }
+
+    /// Account the time elapsed since the previous lap to the phase.
+    auto lap(fit_record::phase p) -> void
+    {
+        if (!record) { return; }
+
+        const auto now = std::chrono::steady_clock::now();
+        record->time[static_cast<size_t>(p)] += std::chrono::duration<double>(now - last).count();
+        if (trace) { trace->complete(fit_stats::phase_name(p), "fit", last, now, name); }
+        last = now;
+    }
+
+private:
+    fit_record* record;
+    tracer* trace;
+    const char* name;
+    std::chrono::steady_clock::time_point last;
+};
+
+/// Modification time and size of the file, identifies the file written by the fitter itself.
+struct file_stamp
+{
+    long long mtime{0}; // nanoseconds
+    long long size{-1}; // -1 if the file does not exist
+
+    auto operator==(const file_stamp& other) const -> bool { return mtime == other.mtime and size == other.size; }
+};
+
+/// Get the stamp of the file.
+/// @param filename file name
+/// @return the stamp, size -1 if the file does not exist
+auto stamp_of(const std::string& filename) -> file_stamp;
+
+/// Definition of the imported entry, see fitter_impl::load().
+struct loaded_entry
+{
+    std::string line;                  // defining line
+    std::vector<std::string> formulas; // compiled formulas, kept in the formula cache
+};
+
 struct fitter_impl
 {
     fitter::priority_mode mode;
+    fitter::fit_engine engine{fitter::fit_engine::root};
+    fit_budget budget;
     format_version input_format_version{format_version::detect};
     format_version output_format_version{format_version::v2};
 
-    static bool verbose_flag;
+    bool verbose_flag{true};
     fit_qa_checker checker{hf::chi2checker()};
 
     std::string par_ref;
     std::string par_aux;
 
     entry generic_parameters;
-    std::map<std::string, entry> hfpmap;
+    registry hfpmap; // many readers, serialized writers
 
     std::string name_decorator{"*"};
     std::string function_decorator{"f_*"};
 
     std::unordered_map<int, draw_opts> partial_functions_styles;
 
+    bin_data fit_data;    // reusable snapshot of the in-range bins for the native engine
+    bin_data coarse_data; // reusable snapshot of the grouped bins for the coarse stage
+    int coarse_factor{0}; // bins grouping of the coarse stage, 0 or 1 disables it
+
+    Double_t refit_threshold{0.0}; // relative change of the integral triggering the online refit
+
+    bool stats_enabled{false};
+    fit_stats stats;
+
+    tracer trace;
+    logger log;
+
+    std::mutex load_mutex;   // serializes the imports, guards the sources selection and the import state below
+    formula_cache formulas;  // compiled formulas of the imported entries
+    std::string loaded_file; // file of the last import
+    std::unordered_map<std::string, std::string> loaded_lines;   // imported line and the name of its entry
+    std::unordered_map<std::string, loaded_entry> loaded_entries; // imported entry name and its definition
+    std::unordered_map<std::string, file_stamp> exported_files;   // files written by export_parameters()
+
+    std::unique_ptr<checkpoint> journal; // completed fits, see fitter::set_checkpoint()
+
+    std::unique_ptr<file_watcher> watcher; // declared last, stopped before the members it uses are destroyed
+
+    /// Select the file to import from the reference and auxiliary files according to the priority mode. Requires
+    /// load_mutex.
+    /// @return the file or empty string if none
+    auto select_file() -> std::string;
+
+    /// Import the entries of the file and publish them at once. The incremental import of the last imported file
+    /// parses only the changed lines and keeps the entries not defined by the file, the full import replaces all
+    /// entries. Requires load_mutex.
+    /// @param filename parameters file
+    /// @param incremental parse only the lines changed since the last import
+    /// @return true if the file was imported
+    auto load(const std::string& filename, bool incremental) -> bool;
+
+    /// Select the file again and import it incrementally. The file written by export_parameters() and not changed
+    /// since holds the registered entries already and is skipped.
+    /// @return true if the file was imported or skipped
+    auto reload() -> bool;
+
+    /// Find the entry or register a copy of the generic entry under the name. The shared pointer keeps the entry
+    /// alive while it is fitted, even if it is removed from the registry meanwhile.
+    /// @param name data object name
+    /// @return the entry
+    /// @throw std::logic_error if the generic entry has no functions
+    auto find_or_make(const char* name) -> std::shared_ptr<entry>;
+
+    /// Fit the coarse snapshot of the data and use the result as the starting point of the full fit. The function
+    /// parameters are updated for the ROOT engine, start_pars for the native one. Failed coarse fit is ignored.
+    template <class T>
+    auto coarse_seed(TF1* function, entry_impl* hfp_m_d, T* dataobj, fit_statistic stat, const fit_budget& limits,
+                     params_vector& start_pars) -> void
+    {
+        make_bin_data(dataobj, hfp_m_d->range_min, hfp_m_d->range_max, stat, coarse_data, coarse_factor);
+        if (coarse_data.size() <= int2size_t(function->GetNumberFreeParameters())) { return; }
+
+        auto coarse_opts = hfp_m_d->minimizer;
+        if (needs_fit_method_function(coarse_opts.algo)) { coarse_opts.algo = minimizer_opts::algorithm::standard; }
+
+        const auto res = minimize(*function, start_pars, coarse_data, stat, coarse_opts, limits);
+        if (res.status != 0) { return; }
+
+        const auto n = start_pars.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (start_pars[i].mode == hf::param::fit_mode::fixed) { continue; }
+
+            start_pars[i].value = res.values[i];
+            function->SetParameter(size_t2int(i), res.values[i]);
+        }
+    }
+
     template <class T>
     auto generic_fit(entry* hfp, entry_impl* hfp_m_d, const char* name, T* dataobj, const char* pars, const char* gpars)
         -> bool
     {
-        hfp_m_d->prepare();
+        const auto tracing = trace.is_enabled();
+        trace_span fit_span(&trace, "fit", "fit", name);
+        tracer_activation trace_activation(&trace);
 
-        TF1* tfSum = &hfp->get_function_object();
-        tfSum->SetName(tools::format_name(name, function_decorator).c_str());
-
-        dataobj->GetListOfFunctions()->Clear();
-        dataobj->GetListOfFunctions()->SetOwner(kTRUE);
+        fit_record record;
+        phase_timer timer(stats_enabled or tracing ? &record : nullptr, tracing ? &trace : nullptr, name);
 
+        TF1* tfSum = &hfp->get_function_object();
         const auto par_num = tfSum->GetNpar();
 
-        // backup old parameters
+        // backup old parameters, taken before seeding, so that a failed fit restores the parameters of the entry
         params_vector backup_old(int2size_t(par_num));
         for (int i = 0; i < par_num; ++i)
             backup_old[int2size_t(i)] = hfp->get_param(i);
 
-        double chi2_backup_old = dataobj->Chisquare(tfSum, "R");
+        if (hfp_m_d->auto_seed)
+        {
+            make_bin_data(dataobj, hfp_m_d->range_min, hfp_m_d->range_max, fit_statistic::likelihood, fit_data);
+            const auto seeded = seed_parameters(*hfp_m_d, fit_data);
+            if (verbose_flag and seeded)
+            {
+                log.log(log_level::debug, fmt::fg(fmt::color::gray),
+                        "* seed {} ({:g}--{:g}) : {} parameters seeded -- *", name, hfp_m_d->range_min,
+                        hfp_m_d->range_max, seeded);
+            }
+        }
+
+        hfp_m_d->prepare();
+
+        tfSum->SetName(tools::format_name(name, function_decorator).c_str());
+
+        if constexpr (is_root_data<T>)
+        {
+            dataobj->GetListOfFunctions()->Clear();
+            dataobj->GetListOfFunctions()->SetOwner(kTRUE);
+        }
+
+        // TH1::Fit cannot be interrupted, so the budgeted fits are native too, which checks the budget in each call
+        const auto limits = merge_budget(hfp_m_d->budget, budget);
+        const auto budgeted = limits.max_calls > 0 or limits.max_time > 0;
+
+        // raw arrays cannot be fitted by ROOT, the algorithms needing the fit method function fall back to default
+        const auto use_native = !is_root_data<T> or ((engine == fitter::fit_engine::native or budgeted) and
+                                                     !needs_fit_method_function(hfp_m_d->minimizer.algo));
+        auto native_opts = hfp_m_d->minimizer;
+        if (needs_fit_method_function(native_opts.algo)) { native_opts.algo = minimizer_opts::algorithm::standard; }
+        const auto stat = statistic_from_option(pars);
+        if (use_native) { make_bin_data(dataobj, hfp_m_d->range_min, hfp_m_d->range_max, stat, fit_data); }
+        timer.lap(fit_record::phase::prepare);
 
-        auto fit_res = dataobj->Fit(tfSum, pars, gpars, hfp->get_fit_range_min(), hfp->get_fit_range_max());
+        auto calc_chi2 = [&]() -> double
+        {
+            if constexpr (is_root_data<T>)
+            {
+                if (!use_native) { return dataobj->Chisquare(tfSum, "R"); }
+            }
+            return chisquare(*tfSum, fit_data);
+        };
 
-        TF1* new_sig_func = dynamic_cast<TF1*>(dataobj->GetListOfFunctions()->At(0));
+        double chi2_backup_old = calc_chi2();
+        timer.lap(fit_record::phase::chi2_pre);
 
-        // TVirtualFitter * fitter = TVirtualFitter::GetFitter();
-        // TMatrixDSym cov;
-        // fitter->GetCovarianceMatrix()
-        // cov.Use(fitter->GetNumberTotalParameters(), fitter->GetCovarianceMatrix());
-        // cov.Print();
+        hfp_m_d->budget_exceeded = false;
+
+        TFitResultPtr fit_res;
+        fit_result result;
+        auto start_pars = hfp_m_d->pars;
+        if (coarse_factor > 1 and supports_grouping(dataobj))
+        {
+            try
+            {
+                coarse_seed(tfSum, hfp_m_d, dataobj, stat, limits, start_pars);
+            }
+            catch (const detail::budget_exceeded&)
+            {
+                hfp_m_d->budget_exceeded = true;
+            }
+        }
+
+        bool fitted_by_root = false;
+        if (hfp_m_d->budget_exceeded)
+        {
+            // aborted in the coarse stage
+        }
+        else if (use_native)
+        {
+            try
+            {
+                auto res = minimize(*tfSum, start_pars, fit_data, stat, native_opts, limits);
+                tfSum->SetParameters(res.values.data());
+                tfSum->SetParErrors(res.errors.data());
+                tfSum->SetNDF(size_t2int(fit_data.size()) - static_cast<int>(res.nfree));
+                tfSum->SetNumberFitPoints(size_t2int(fit_data.size()));
+                fit_res = TFitResultPtr(res.status);
+                record.ncalls = res.ncalls;
+                result.edm = res.edm;
+                result.covariance = std::move(res.covariance);
+            }
+            catch (const detail::budget_exceeded&)
+            {
+                hfp_m_d->budget_exceeded = true;
+            }
+        }
+        else if constexpr (is_root_data<T>)
+        {
+            // only the algorithms the native engine cannot drive get here with a budget: the calls are limited by the
+            // minimizer and the time is checked after the fit
+            const auto start = std::chrono::steady_clock::now();
+            // the fit result is kept for the covariance, see fit_result
+            const auto fit_pars = std::string(pars ? pars : "") + "S";
+
+            default_minimizer_guard minimizer_guard(limit_calls(hfp_m_d->minimizer, limits));
+            fit_res = dataobj->Fit(tfSum, fit_pars.c_str(), gpars, hfp->get_fit_range_min(), hfp->get_fit_range_max());
+            fitted_by_root = true;
+
+            const auto elapsed = std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
+            if (limits.max_time > 0 and elapsed > limits.max_time) { hfp_m_d->budget_exceeded = true; }
+            if (limits.max_calls > 0 and fit_res.Get() and
+                fit_res->NCalls() >= static_cast<unsigned int>(limits.max_calls))
+            {
+                hfp_m_d->budget_exceeded = true;
+            }
+            if (fit_res.Get())
+            {
+                record.ncalls = fit_res->NCalls();
+                result.edm = fit_res->Edm();
+                if (fit_res->CovMatrixStatus() > 0)
+                {
+                    result.covariance.reserve(fit_result::packed_index(par_num, 0));
+                    for (unsigned int i = 0; i < static_cast<unsigned int>(par_num); ++i)
+                        for (unsigned int j = 0; j <= i; ++j)
+                            result.covariance.push_back(fit_res->CovMatrix(i, j));
+                }
+            }
+        }
+        timer.lap(fit_record::phase::minimize);
+
+        // raw arrays have no list of functions, the entry function is the only result
+        TF1* new_sig_func = tfSum;
+        if constexpr (is_root_data<T>)
+        {
+            if (!fitted_by_root) { dataobj->GetListOfFunctions()->Add(tfSum->Clone()); }
+            new_sig_func = dynamic_cast<TF1*>(dataobj->GetListOfFunctions()->At(0));
+        }
+        timer.lap(fit_record::phase::clone);
+
+        double chi2_backup_new = calc_chi2();
+        timer.lap(fit_record::phase::chi2_post);
 
         // backup new parameters
         params_vector backup_new = backup_old;
         for (int i = 0; i < par_num; ++i)
             backup_new[int2size_t(i)].value = tfSum->GetParameter(i);
 
-        double chi2_backup_new = dataobj->Chisquare(tfSum, "R");
-
-        auto qa_res = checker(backup_old, chi2_backup_old, backup_new, chi2_backup_new, fit_res);
+        auto qa_res = hfp_m_d->budget_exceeded
+                          ? -1
+                          : checker(backup_old, chi2_backup_old, backup_new, chi2_backup_new, fit_res);
 
         if (qa_res > 0)
         {
-            if (verbose_flag)
+            if (verbose_flag and log.enabled(log_level::info))
             {
-                fmt::print(fmt::fg(fmt::color::royal_blue), "* old  {} ({:g}--{:g}) : {} --> chi2:  {:} -- *\n", name,
-                           hfp_m_d->range_min, hfp_m_d->range_max, backup_old, chi2_backup_old);
-                fmt::print(fmt::fg(fmt::color::lime_green), "* new  {} ({:g}--{:g}) : {} --> chi2:  {:} -- *", name,
-                           hfp_m_d->range_min, hfp_m_d->range_max, backup_new, chi2_backup_new);
-                fmt::print("{}\n", "\t [ OK ]");
+                log.log(log_level::info, "{}\n{}\t [ OK ]\n",
+                        fmt::format(fmt::fg(fmt::color::royal_blue), "* old  {} ({:g}--{:g}) : {} --> chi2:  {:} -- *",
+                                    name, hfp_m_d->range_min, hfp_m_d->range_max, backup_old, chi2_backup_old),
+                        fmt::format(fmt::fg(fmt::color::lime_green), "* new  {} ({:g}--{:g}) : {} --> chi2:  {:} -- *",
+                                    name, hfp_m_d->range_min, hfp_m_d->range_max, backup_new, chi2_backup_new));
             }
         }
         else if (qa_res == 0)
         {
-            if (verbose_flag)
+            if (verbose_flag and log.enabled(log_level::info))
             {
-                fmt::print(fmt::fg(fmt::color::orange), "* fine {} ({:g}--{:g}) : {} --> chi2:  {:} -- *", name,
-                           hfp_m_d->range_min, hfp_m_d->range_max, backup_old, chi2_backup_new);
-                fmt::print("{}\n", "\t [ pass ]");
+                log.log(log_level::info, "{}\t [ pass ]\n",
+                        fmt::format(fmt::fg(fmt::color::orange), "* fine {} ({:g}--{:g}) : {} --> chi2:  {:} -- *",
+                                    name, hfp_m_d->range_min, hfp_m_d->range_max, backup_old, chi2_backup_new));
             }
         }
         else
@@ -253,19 +604,33 @@ struct fitter_impl
                 new_sig_func->SetParameter(i, backup_old[int2size_t(i)].value);
             }
 
-            if (verbose_flag)
+            if (verbose_flag and log.enabled(log_level::warning))
             {
-                fmt::print(fmt::fg(fmt::color::royal_blue), "* old  {} ({:g}--{:g}) : {} --> chi2:  {:} -- *\n", name,
-                           hfp_m_d->range_min, hfp_m_d->range_max, backup_old, chi2_backup_old);
-                fmt::print(fmt::fg(fmt::color::crimson), "* new  {} ({:g}--{:g}) : {} --> chi2:  {:} -- *", name,
-                           hfp_m_d->range_min, hfp_m_d->range_max, backup_new, chi2_backup_new);
-                fmt::print("{}\n", "\t [ FAILED - restoring old params ]");
+                log.log(log_level::warning, "{}\n{}{}\n",
+                        fmt::format(fmt::fg(fmt::color::royal_blue), "* old  {} ({:g}--{:g}) : {} --> chi2:  {:} -- *",
+                                    name, hfp_m_d->range_min, hfp_m_d->range_max, backup_old, chi2_backup_old),
+                        fmt::format(fmt::fg(fmt::color::crimson), "* new  {} ({:g}--{:g}) : {} --> chi2:  {:} -- *",
+                                    name, hfp_m_d->range_min, hfp_m_d->range_max, backup_new, chi2_backup_new),
+                        hfp_m_d->budget_exceeded ? "\t [ ABORTED - budget exceeded, restoring old params ]"
+                                                 : "\t [ FAILED - restoring old params ]");
             }
         }
 
-        tfSum->SetChisquare(dataobj->Chisquare(tfSum, "R"));
+        timer.lap(fit_record::phase::qa);
 
-        new_sig_func->SetChisquare(dataobj->Chisquare(tfSum, "R"));
+        const auto chi2_final = calc_chi2();
+        tfSum->SetChisquare(chi2_final);
+        new_sig_func->SetChisquare(chi2_final);
+        timer.lap(fit_record::phase::chi2_final);
+
+        result.status = fit_res;
+        result.qa = qa_res;
+        result.ncalls = record.ncalls;
+        result.chi2 = chi2_final;
+        result.ndf = tfSum->GetNDF();
+        result.npar = par_num;
+        if (qa_res < 0) { result.covariance.clear(); }
+        hfp_m_d->result = std::move(result);
 
         const auto functions_count = hfp->get_functions_count();
 
@@ -286,6 +651,26 @@ struct fitter_impl
 
             hfp->update_param(i, par);
         }
+        timer.lap(fit_record::phase::propagate);
+
+        if constexpr (is_root_data<T>) { attach_functions(hfp, hfp_m_d, name, dataobj); }
+        timer.lap(fit_record::phase::attach);
+
+        if (stats_enabled)
+        {
+            record.name = name;
+            record.status = fit_res;
+            record.qa = qa_res;
+            stats.add(std::move(record));
+        }
+
+        return !hfp_m_d->budget_exceeded;
+    }
+
+    /// Style the complete function attached to the data object and attach the styled clones of the partial functions.
+    template <class T> auto attach_functions(entry* hfp, entry_impl* hfp_m_d, const char* name, T* dataobj) -> void
+    {
+        const auto functions_count = hfp->get_functions_count();
 
         auto complete_function = dynamic_cast<TF1*>(dataobj->GetListOfFunctions()->At(0));
         if (!apply_style(complete_function, hfp_m_d->partial_functions_styles, -1))
@@ -312,8 +697,6 @@ struct fitter_impl
 
             dataobj->GetListOfFunctions()->Add(cloned);
         }
-
-        return true;
     }
 };
 
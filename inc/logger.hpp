@@ -0,0 +1,93 @@
+#ifndef HELLOFITTY_LOGGER_H
+#define HELLOFITTY_LOGGER_H
+
+#include "hellofitty.hpp"
+
+#include <fmt/color.h>
+#include <fmt/core.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace hf::detail
+{
+
+/// Process-wide background writer. Messages are queued by the loggers and written by a single thread, so the fitting
+/// threads do not wait for the console. The thread is started with the first message. The sink is never destroyed, so
+/// the loggers may be used from static destructors: the queue is drained at exit, later messages are written directly.
+class log_sink final
+{
+public:
+    static auto instance() -> log_sink&;
+
+    log_sink(const log_sink&) = delete;
+    auto operator=(const log_sink&) -> log_sink& = delete;
+
+    /// Queue the message, blocks if the queue is full. Written directly after the exit started.
+    auto push(std::FILE* stream, std::string message) -> void;
+
+    /// Wait until all queued messages are written.
+    auto flush() -> void;
+
+private:
+    log_sink() = default;
+    ~log_sink() = default;
+
+    auto run() -> void;
+    auto shutdown() -> void; // at exit: drain the queue and write the next messages directly
+
+    static constexpr size_t max_queued = 65536;
+
+    std::mutex mutex;
+    std::condition_variable queue_cv;
+    std::condition_variable space_cv;
+    std::condition_variable drained_cv;
+    std::deque<std::pair<std::FILE*, std::string>> queue;
+    bool writing{false};
+    bool direct{false};
+    std::thread worker; // detached, ends with the process
+};
+
+/// Levelled logger owned by the fitter. Messages below the level are neither formatted nor queued. Warnings and errors
+/// go to stderr, other messages to stdout. Messages are written by the calling thread unless asynchronous output is
+/// enabled; warnings and errors are written directly always, so they are not lost when the process aborts.
+class logger final
+{
+public:
+    auto set_level(log_level lvl) -> void { level = lvl; }
+    auto get_level() const -> log_level { return level; }
+
+    auto set_async(bool enable) -> void { async = enable; }
+    auto is_async() const -> bool { return async; }
+
+    auto enabled(log_level lvl) const -> bool { return lvl >= level and lvl != log_level::off; }
+
+    template <typename... Args> auto log(log_level lvl, fmt::format_string<Args...> format, Args&&... args) -> void
+    {
+        if (!enabled(lvl)) { return; }
+        write(lvl, fmt::format(format, std::forward<Args>(args)...));
+    }
+
+    /// Log the styled message, the new line is appended after the style is reset.
+    template <typename... Args>
+    auto log(log_level lvl, const fmt::text_style& style, fmt::format_string<Args...> format, Args&&... args) -> void
+    {
+        if (!enabled(lvl)) { return; }
+        write(lvl, fmt::format("{}\n", fmt::styled(fmt::format(format, std::forward<Args>(args)...), style)));
+    }
+
+private:
+    auto write(log_level lvl, std::string message) const -> void;
+
+    log_level level{log_level::info};
+    bool async{false};
+};
+
+} // namespace hf::detail
+
+#endif /* HELLOFITTY_LOGGER_H */
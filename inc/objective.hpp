@@ -0,0 +1,272 @@
+#ifndef HELLOFITTY_OBJECTIVE_H
+#define HELLOFITTY_OBJECTIVE_H
+
+#include "hellofitty.hpp"
+
+#include <RtypesCore.h>
+
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class TF1;
+class TGraph;
+class TH1;
+class TH2;
+
+namespace hf::detail
+{
+
+/// Statistic minimized by the native fitting engine.
+enum class fit_statistic
+{
+    chi2,      ///< Neyman chi2, empty bins are skipped
+    likelihood ///< Poisson likelihood (Baker-Cousins), empty bins are kept
+};
+
+/// Packed structure-of-arrays snapshot of the data points located in the fit range. Built once per fit and then
+/// consumed by the objective function without touching the data object again.
+struct bin_data final
+{
+    std::vector<Double_t> x;  ///< bin centers (or graph points)
+    std::vector<Double_t> y;  ///< bin content
+    std::vector<Double_t> ey; ///< bin error, 0 marks an empty bin kept for the likelihood
+
+    auto size() const -> size_t { return x.size(); }
+
+    auto clear() -> void
+    {
+        x.clear();
+        y.clear();
+        ey.clear();
+    }
+
+    auto reserve(size_t n) -> void
+    {
+        x.reserve(n);
+        y.reserve(n);
+        ey.reserve(n);
+    }
+
+    auto push_back(Double_t px, Double_t py, Double_t pey) -> void
+    {
+        x.push_back(px);
+        y.push_back(py);
+        ey.push_back(pey);
+    }
+};
+
+/// Data points given by plain arrays owned by the caller, see fitter::fit_points().
+struct raw_points final
+{
+    size_t n{0};                 ///< number of points
+    const Double_t* x{nullptr};  ///< x values
+    const Double_t* y{nullptr};  ///< y values
+    const Double_t* ey{nullptr}; ///< y errors, unit errors if null
+};
+
+/// Histogram given by plain arrays owned by the caller, see fitter::fit_bins().
+struct raw_bins final
+{
+    size_t n{0};                     ///< number of bins
+    const Double_t* edges{nullptr};  ///< n+1 bin edges, increasing
+    const Double_t* counts{nullptr}; ///< bin contents
+    const Double_t* errors{nullptr}; ///< bin errors, sqrt(counts) if null
+};
+
+/// True for the ROOT data objects (TH1, TGraph) which carry the list of functions and can be fitted by ROOT. Raw
+/// arrays are always fitted by the native engine and nothing is attached to them.
+template <class T> constexpr bool is_root_data = !std::is_same<std::remove_cv_t<T>, raw_points>::value and
+                                                 !std::is_same<std::remove_cv_t<T>, raw_bins>::value;
+
+/// Result of the native minimization.
+struct native_result final
+{
+    int status{-1};               ///< minimizer status, 0 on success
+    Double_t fval{0.0};           ///< objective value at minimum
+    Double_t edm{0.0};            ///< estimated distance to minimum
+    unsigned int ncalls{0};       ///< number of the objective function calls
+    unsigned int nfree{0};        ///< number of the free parameters
+    std::vector<Double_t> values; ///< parameter values
+    std::vector<Double_t> errors; ///< parameter errors
+    std::vector<Double_t> covariance; ///< packed lower triangle, see fit_result, empty if not available
+};
+
+/// Thrown by the native objective when the fit budget is exceeded, aborts the minimization.
+class budget_exceeded : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// Combine entry and global budgets, the limits set in the entry take precedence.
+/// @param local entry budget
+/// @param global fitter budget
+/// @return effective budget
+constexpr auto merge_budget(const fit_budget& local, const fit_budget& global) -> fit_budget
+{
+    return fit_budget{local.max_calls > 0 ? local.max_calls : global.max_calls,
+                      local.max_time > 0 ? local.max_time : global.max_time};
+}
+
+/// Limit the minimizer calls to the budget calls.
+/// @param opts minimizer options
+/// @param budget fit budget
+/// @return minimizer options with calls limit not exceeding the budget
+constexpr auto limit_calls(minimizer_opts opts, const fit_budget& budget) -> minimizer_opts
+{
+    if (budget.max_calls > 0 and (opts.max_calls <= 0 or opts.max_calls > budget.max_calls))
+    {
+        opts.max_calls = budget.max_calls;
+    }
+    return opts;
+}
+
+/// Mutex of ROOT's global default minimizer options, see default_minimizer_guard.
+auto minimizer_defaults_mutex() -> std::shared_mutex&;
+
+/// Minimizer type and algorithm names as understood by ROOT::Math::Factory.
+/// @param algo the algorithm
+/// @return pair of type and algorithm names
+auto minimizer_names(minimizer_opts::algorithm algo) -> std::pair<std::string, std::string>;
+
+/// Fumili2 and GSL-LM require the per-point fit method function which ROOT builds in TH1::Fit. The native objective is
+/// a generic function, so such entries are fitted with the ROOT engine.
+/// @param algo the algorithm
+/// @return true if the native objective cannot drive the algorithm
+constexpr auto needs_fit_method_function(minimizer_opts::algorithm algo) -> bool
+{
+    return algo == minimizer_opts::algorithm::fumili2 or algo == minimizer_opts::algorithm::gsl_lm;
+}
+
+/// Overrides ROOT's default minimizer options for the lifetime of the object, the previous defaults are restored on
+/// destruction. Used by the ROOT engine which has no other way to accept the minimizer settings. The defaults are
+/// global, so the guard also locks them: shared if nothing is overridden, exclusive otherwise. Fits running on other
+/// threads with different settings wait for each other, fits with default settings run concurrently.
+class default_minimizer_guard final
+{
+public:
+    explicit default_minimizer_guard(const minimizer_opts& opts);
+    default_minimizer_guard(const default_minimizer_guard&) = delete;
+    auto operator=(const default_minimizer_guard&) -> default_minimizer_guard& = delete;
+    ~default_minimizer_guard();
+
+private:
+    std::shared_lock<std::shared_mutex> shared;
+    std::unique_lock<std::shared_mutex> exclusive;
+    bool active{false};
+    std::string type;
+    std::string algo;
+    int strategy{0};
+    Double_t tolerance{0.0};
+    int max_calls{0};
+};
+
+/// Select statistic based on the ROOT-like fit option string, "L" requests the likelihood.
+auto statistic_from_option(const char* option) -> fit_statistic;
+
+/// Fill the buffer with the histogram bins in the given range. A bin is in range if its center is, as in TH1::Fit. The
+/// buffer is cleared first, its capacity is reused.
+/// Grouped bins hold the average content of the group, so the model parameters keep their scale. The histogram itself
+/// is not modified.
+/// @param hist histogram
+/// @param range_min lower range
+/// @param range_max upper range
+/// @param stat statistic, decides whether empty bins are skipped
+/// @param data output buffer
+/// @param group number of adjacent bins merged into one point
+auto make_bin_data(const TH1* hist, Double_t range_min, Double_t range_max, fit_statistic stat, bin_data& data,
+                   int group = 1) -> void;
+
+/// Fill the buffer with the graph points in the given range. Points without errors get unit error.
+/// @param graph graph
+/// @param range_min lower range
+/// @param range_max upper range
+/// @param stat statistic, unused for graphs
+/// @param data output buffer
+/// @param group unused, graph points cannot be grouped
+auto make_bin_data(const TGraph* graph, Double_t range_min, Double_t range_max, fit_statistic stat, bin_data& data,
+                   int group = 1) -> void;
+
+/// Fill the buffer with the raw points in the given range. Points without errors get unit error.
+/// @param points raw points
+/// @param range_min lower range
+/// @param range_max upper range
+/// @param stat statistic, unused for points
+/// @param data output buffer
+/// @param group unused, points cannot be grouped
+auto make_bin_data(const raw_points* points, Double_t range_min, Double_t range_max, fit_statistic stat,
+                   bin_data& data, int group = 1) -> void;
+
+/// Fill the buffer with the raw bins in the given range, grouping as for histograms. A bin is in range if its center
+/// is.
+/// @param bins raw bins
+/// @param range_min lower range
+/// @param range_max upper range
+/// @param stat statistic, decides whether empty bins are skipped
+/// @param data output buffer
+/// @param group number of adjacent bins merged into one point
+auto make_bin_data(const raw_bins* bins, Double_t range_min, Double_t range_max, fit_statistic stat, bin_data& data,
+                   int group = 1) -> void;
+
+/// Fill the buffer with the bins of a single slice of the 2D histogram, in the given range of the fitted axis. Empty
+/// bins are handled as in make_bin_data().
+/// @param hist 2D histogram
+/// @param slice bin number on the sliced axis
+/// @param along_x fit along x axis (slice is y bin), otherwise along y axis (slice is x bin)
+/// @param range_min lower range
+/// @param range_max upper range
+/// @param stat statistic, decides whether empty bins are skipped
+/// @param data output buffer
+auto make_slice_data(const TH2* hist, int slice, bool along_x, Double_t range_min, Double_t range_max,
+                     fit_statistic stat, bin_data& data) -> void;
+
+/// Check whether the data points can be grouped, see make_bin_data().
+constexpr auto supports_grouping(const TH1* /*hist*/) -> bool { return true; }
+constexpr auto supports_grouping(const TGraph* /*graph*/) -> bool { return false; }
+constexpr auto supports_grouping(const raw_points* /*points*/) -> bool { return false; }
+constexpr auto supports_grouping(const raw_bins* /*bins*/) -> bool { return true; }
+
+/// Calculate chi2 of the function with its current parameters over the data. Empty bins are skipped.
+auto chisquare(TF1& function, const bin_data& data) -> Double_t;
+
+/// Calculate the objective for given parameters.
+auto objective(TF1& function, const bin_data& data, fit_statistic stat, const Double_t* pars) -> Double_t;
+
+/// Minimize the objective built over data, using the parameters setup (limits, fixed) from pars.
+/// @param function model function, parameters are not modified
+/// @param pars parameters setup
+/// @param data data points
+/// @param stat statistic to minimize
+/// @param opts minimizer selection and tuning
+/// @param budget fit budget
+/// @return minimization result
+/// @throw budget_exceeded if the budget is exceeded
+auto minimize(TF1& function, const std::vector<param>& pars, const bin_data& data, fit_statistic stat,
+              const minimizer_opts& opts = minimizer_opts(), const fit_budget& budget = fit_budget())
+    -> native_result;
+
+/// Objective of the parameters values, see minimize().
+using objective_function = std::function<Double_t(const Double_t*)>;
+
+/// Minimize a generic objective, using the parameters setup (limits, fixed) from pars. The number of parameters is
+/// given by pars.
+/// @param fcn objective function
+/// @param pars parameters setup
+/// @param par_names parameters names, same size as pars
+/// @param opts minimizer selection and tuning
+/// @param budget fit budget
+/// @return minimization result
+/// @throw budget_exceeded if the budget is exceeded
+auto minimize(const objective_function& fcn, const std::vector<param>& pars, const std::vector<std::string>& par_names,
+              const minimizer_opts& opts = minimizer_opts(), const fit_budget& budget = fit_budget())
+    -> native_result;
+
+} // namespace hf::detail
+
+#endif /* HELLOFITTY_OBJECTIVE_H */
@@ -0,0 +1,176 @@
+#ifndef HELLOFITTY_PARALLEL_H
+#define HELLOFITTY_PARALLEL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace hf::detail
+{
+
+/// Number of chunks the tasks are split into.
+/// @param threads requested number of threads, 0 or negative for hardware concurrency
+/// @param tasks number of tasks
+/// @return number of chunks, at least 1
+inline auto chunks_count(int threads, int tasks) -> int
+{
+    if (threads <= 0) { threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency())); }
+    return std::max(1, std::min(threads, tasks));
+}
+
+/// First task of the chunk, the chunk ends where the next one begins. Chunks are contiguous and differ in size by at
+/// most one task.
+/// @param chunk chunk index, may be equal to chunks to get the end of the last chunk
+/// @param chunks number of chunks
+/// @param tasks number of tasks
+/// @return index of the first task
+constexpr auto chunk_begin(int chunk, int chunks, int tasks) -> int
+{
+    return static_cast<int>(static_cast<long long>(chunk) * tasks / chunks);
+}
+
+/// Call work(chunk) for each chunk, each on own thread if there is more than one chunk, and wait for all of them.
+/// @param chunks number of chunks
+/// @param work callable taking the chunk index
+/// @throw the first exception thrown by the work, after all chunks finished
+template <class F> auto run_chunks(int chunks, F&& work) -> void
+{
+    if (chunks == 1)
+    {
+        work(0);
+        return;
+    }
+
+    std::vector<std::exception_ptr> failures(static_cast<size_t>(chunks));
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(chunks));
+    for (auto chunk = 0; chunk < chunks; ++chunk)
+    {
+        workers.emplace_back(
+            [&, chunk]
+            {
+                try
+                {
+                    work(chunk);
+                }
+                catch (...)
+                {
+                    failures[static_cast<size_t>(chunk)] = std::current_exception();
+                }
+            });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    for (const auto& failure : failures)
+    {
+        if (failure) { std::rethrow_exception(failure); }
+    }
+}
+
+/// Threads kept for repeated runs of short chunked work, where starting the threads for every run as in run_chunks()
+/// would dominate. The chunk 0 runs on the calling thread, every other chunk on own thread.
+class chunk_pool final
+{
+public:
+    /// @param chunks number of chunks
+    explicit chunk_pool(int chunks) : chunks_number(std::max(chunks, 1)), failures(static_cast<size_t>(chunks_number))
+    {
+        workers.reserve(static_cast<size_t>(chunks_number - 1));
+        for (auto chunk = 1; chunk < chunks_number; ++chunk)
+            workers.emplace_back([this, chunk] { serve(chunk); });
+    }
+    chunk_pool(const chunk_pool&) = delete;
+    auto operator=(const chunk_pool&) -> chunk_pool& = delete;
+
+    ~chunk_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    auto chunks() const -> int { return chunks_number; }
+
+    /// Call work(chunk) for each chunk and wait for all of them.
+    /// @param work callable taking the chunk index
+    /// @throw the first exception thrown by the work, after all chunks finished
+    template <class F> auto run(F&& work) -> void
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = [&work](int chunk) { work(chunk); };
+            pending = chunks_number - 1;
+            ++generation;
+        }
+        wake.notify_all();
+
+        execute(0);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return pending == 0; });
+            job = nullptr;
+        }
+
+        for (auto& failure : failures)
+        {
+            if (failure) { std::rethrow_exception(std::exchange(failure, nullptr)); }
+        }
+    }
+
+private:
+    auto execute(int chunk) -> void
+    {
+        try
+        {
+            job(chunk);
+        }
+        catch (...)
+        {
+            failures[static_cast<size_t>(chunk)] = std::current_exception();
+        }
+    }
+
+    auto serve(int chunk) -> void
+    {
+        unsigned long seen = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping or generation != seen; });
+                if (stopping) { return; }
+                seen = generation;
+            }
+
+            execute(chunk);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) { done.notify_one(); }
+        }
+    }
+
+    int chunks_number;
+    std::vector<std::exception_ptr> failures;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function<void(int)> job;
+    unsigned long generation{0};
+    int pending{0};
+    bool stopping{false};
+};
+
+} // namespace hf::detail
+
+#endif /* HELLOFITTY_PARALLEL_H */
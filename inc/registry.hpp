@@ -0,0 +1,209 @@
+#ifndef HELLOFITTY_REGISTRY_H
+#define HELLOFITTY_REGISTRY_H
+
+#include "hellofitty.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hf::detail
+{
+
+/// Immutable ordered map of the named entries. A modification returns a new version which shares all nodes apart from
+/// the O(log N) ones on the path to the modified name with the original version, so a version derived from a large map
+/// is cheap. The nodes form a treap ordered by the name and balanced by the hash of the name.
+class entry_map final
+{
+    struct node;
+    using node_ptr = std::shared_ptr<const node>;
+
+public:
+    using value_type = std::pair<const std::string, std::shared_ptr<entry>>;
+
+    /// In-order iterator, the stack of the nodes left of the current one is kept in the iterator.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = entry_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        auto operator*() const -> reference;
+        auto operator->() const -> pointer { return &**this; }
+        auto operator++() -> const_iterator&;
+        auto operator++(int) -> const_iterator;
+        auto operator==(const const_iterator& other) const -> bool { return path == other.path; }
+        auto operator!=(const const_iterator& other) const -> bool { return path != other.path; }
+
+    private:
+        friend class entry_map;
+        auto descend(const node* n) -> void;
+
+        std::vector<const node*> path; // the current node is the last one, empty at the end
+    };
+
+    /// Memory of a node apart from its value.
+    static const size_t node_overhead;
+
+    entry_map() = default;
+
+    auto begin() const -> const_iterator;
+    auto end() const -> const_iterator { return {}; }
+    auto size() const -> size_t { return count; }
+    auto empty() const -> bool { return count == 0; }
+
+    /// @param name entry name
+    /// @return iterator to the entry, end() if not found
+    auto find(const std::string& name) const -> const_iterator;
+
+    /// Version with the entry inserted, or with the existing entry of the name replaced.
+    /// @param name entry name
+    /// @param hfp entry
+    /// @return the new version
+    auto insert(std::string name, std::shared_ptr<entry> hfp) const -> entry_map;
+
+    /// Version without the name.
+    /// @param name entry name
+    /// @return the new version, or a copy of this one if the name is not in the map
+    auto erase(const std::string& name) const -> entry_map;
+
+private:
+    entry_map(node_ptr tree, size_t size) : root(std::move(tree)), count(size) {}
+
+    static auto split(const node_ptr& tree, const std::string& name) -> std::pair<node_ptr, node_ptr>;
+    static auto merge(const node_ptr& left, const node_ptr& right) -> node_ptr;
+    static auto insert(const node_ptr& tree, node_ptr added) -> node_ptr;
+    static auto erase(const node_ptr& tree, const std::string& name) -> node_ptr;
+
+    node_ptr root;
+    size_t count{0};
+};
+
+/// Named entries with RCU-style reads. The map is immutable once published: readers load the current version with a
+/// single atomic load and never take a lock, so lookups from many threads do not contend. The writer derives a new
+/// version of the map and publishes it; the old version is freed once no reader which could have seen it is still
+/// inside its read section (epoch based reclamation). The versions share the unchanged nodes and the entries, so
+/// adding a name costs O(log N), see entry_map.
+///
+/// Writers are serialized by a lock which readers never touch. A registered entry is never changed by the registry: a
+/// replacement is a new entry published in a new version, the old one stays with the versions and the readers which
+/// still hold it. An entry pointer obtained from a read stays valid until the entry is replaced or removed, use
+/// find_shared() to keep the entry alive beyond that.
+class registry final
+{
+public:
+    using map_type = entry_map;
+
+    registry();
+    registry(const registry&) = delete;
+    auto operator=(const registry&) -> registry& = delete;
+    ~registry();
+
+    /// Find the entry, wait-free apart from the first call on a thread.
+    /// @param name entry name
+    /// @return the entry or nullptr
+    auto find(const std::string& name) const -> entry*;
+
+    /// Find the entry and share its ownership, the entry survives its removal from the registry.
+    /// @param name entry name
+    /// @return the entry or empty pointer
+    auto find_shared(const std::string& name) const -> std::shared_ptr<entry>;
+
+    /// Call the function with the current version of the map, which is not freed until the function returns.
+    /// @param fun callable taking const map_type&
+    /// @return result of the function
+    template <class F> auto read(F&& fun) const -> decltype(fun(std::declval<const map_type&>()))
+    {
+        read_section section(*this);
+        return fun(*section.map);
+    }
+
+    /// Number of entries in the current version.
+    auto size() const -> size_t;
+
+    /// Number of reader slots, bounded by the number of threads alive which have read the registry.
+    auto reader_slots() const -> size_t;
+
+    /// Insert the entry, or replace the existing one with the same name.
+    /// @param name entry name
+    /// @param hfp the entry
+    /// @return pointer to the registered entry
+    auto insert(std::string name, entry hfp) -> entry*;
+
+    /// Insert as insert() and share the ownership of the registered entry.
+    /// @param name entry name
+    /// @param hfp the entry
+    /// @return the registered entry
+    auto insert_shared(std::string name, entry hfp) -> std::shared_ptr<entry>;
+
+    /// Find the entry, or insert a copy of the given one if the name is not registered. Threads racing for the same
+    /// name get the same entry.
+    /// @param name entry name
+    /// @param hfp the entry copied if the name is not registered
+    /// @return the registered entry
+    auto find_or_insert(const std::string& name, const entry& hfp) -> std::shared_ptr<entry>;
+
+    /// Insert or replace the entries and remove the names, all published at once in a single new version.
+    /// @param entries entries to insert or replace, the last one of a name wins
+    /// @param removed names to remove
+    /// @param remove_others remove also all names which are not in entries
+    /// @return number of removed entries
+    auto update(std::vector<std::pair<std::string, entry>> entries, const std::vector<std::string>& removed,
+                bool remove_others = false) -> size_t;
+
+    /// Replace the whole content at once, readers see either the old or the new content, never a mix.
+    /// @param map new content
+    auto publish(map_type map) -> void;
+
+    /// Remove all entries.
+    auto clear() -> void { publish(map_type()); }
+
+private:
+    struct reader_slot
+    {
+        std::atomic<std::uint64_t> epoch{0}; // epoch at the section start, 0 when outside of the section
+        unsigned depth{0};                   // nesting level, touched only by the owning thread
+        std::atomic<bool> owned{true};       // released on the exit of the owning thread, then reused
+    };
+
+    /// Protects the current map version from reclamation for its lifetime, may be nested.
+    struct read_section
+    {
+        explicit read_section(const registry& reg);
+        read_section(const read_section&) = delete;
+        auto operator=(const read_section&) -> read_section& = delete;
+        ~read_section();
+
+        reader_slot& slot;
+        const map_type* map;
+    };
+
+    auto local_slot() const -> reader_slot&;
+    auto replace(map_type map) -> void; // publish with the write lock held
+    auto reclaim() -> void;
+
+    const std::uint64_t id; // unique among all registries, used to find the thread slot
+    std::atomic<const map_type*> current;
+    std::atomic<std::uint64_t> epoch{1};
+
+    mutable std::mutex slots_mutex;
+    mutable std::vector<std::shared_ptr<reader_slot>> slots; // shared with the owning threads
+
+    std::mutex write_mutex;
+    std::vector<std::pair<std::uint64_t, const map_type*>> retired; // guarded by write_mutex
+};
+
+} // namespace hf::detail
+
+#endif /* HELLOFITTY_REGISTRY_H */
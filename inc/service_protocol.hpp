@@ -0,0 +1,104 @@
+#ifndef HELLOFITTY_SERVICE_PROTOCOL_H
+#define HELLOFITTY_SERVICE_PROTOCOL_H
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <string>
+
+/// Protocol of the fit service, shared by the service and the client. Both sides exchange single lines of
+/// whitespace-separated tokens terminated by '\n'. Requests:
+///
+///     PING
+///     FIT <entry> <options> <n> <edge_0> ... <edge_n> <count_1> ... <count_n> [<error_1> ... <error_n>]
+///
+/// Replies:
+///
+///     OK
+///     OK <status> <qa> <chi2> <ndf> <npar> <value_0> <error_0> ... <value_npar-1> <error_npar-1>
+///     ERR <message>
+///
+/// Numbers are written with full precision, so the values survive the round trip exactly. The errors of a fit rejected
+/// by the quality checker, qa < 0, are 0. Requests may be pipelined, but a client which does not read its replies is
+/// not served until it does, without blocking the other clients.
+
+namespace hf::detail
+{
+
+/// Longest accepted line, longer requests are rejected and the connection is closed.
+constexpr size_t service_max_line = 64 * 1024 * 1024;
+
+/// Format the number so it is parsed back to the same value.
+inline auto service_format(double value) -> std::string
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+#if defined(MSG_NOSIGNAL)
+constexpr int service_send_flags = MSG_NOSIGNAL;
+#else
+constexpr int service_send_flags = 0; // SO_NOSIGPIPE is set by service_configure()
+#endif
+
+/// Set up the new socket: not inherited by child processes, the broken connection does not raise SIGPIPE.
+inline auto service_configure(int fd) -> void
+{
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+}
+
+/// Send all data to the socket, retrying on interrupts.
+/// @return false if the connection failed
+inline auto service_send(int fd, const std::string& data) -> bool
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        const auto res = ::send(fd, data.data() + sent, data.size() - sent, service_send_flags);
+        if (res < 0 and errno == EINTR) { continue; }
+        if (res <= 0) { return false; }
+        sent += static_cast<size_t>(res);
+    }
+    return true;
+}
+
+/// Move the first complete line from the buffer to line, without the terminator.
+/// @return false if the buffer holds no complete line
+inline auto service_take_line(std::string& buffer, std::string& line) -> bool
+{
+    const auto end = buffer.find('\n');
+    if (end == std::string::npos) { return false; }
+
+    line.assign(buffer, 0, end);
+    buffer.erase(0, end + 1);
+    return true;
+}
+
+/// Read from the socket once and append to the buffer, retrying on interrupts.
+/// @return false on end of stream or error
+inline auto service_receive(int fd, std::string& buffer) -> bool
+{
+    char chunk[64 * 1024];
+    while (true)
+    {
+        const auto res = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (res < 0 and errno == EINTR) { continue; }
+        if (res <= 0) { return false; }
+
+        buffer.append(chunk, static_cast<size_t>(res));
+        return true;
+    }
+}
+
+} // namespace hf::detail
+
+#endif /* HELLOFITTY_SERVICE_PROTOCOL_H */
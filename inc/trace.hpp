@@ -0,0 +1,122 @@
+#ifndef HELLOFITTY_TRACE_H
+#define HELLOFITTY_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hf::detail
+{
+
+/// Collects complete-duration events and writes them in the Chrome JSON trace format, which can be opened in Perfetto
+/// or chrome://tracing. Each thread appends to its own buffer, the shared lock is taken only when a thread records its
+/// first event. Writing and clearing must not run concurrently with recording.
+class tracer final
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    tracer();
+    tracer(const tracer&) = delete;
+    auto operator=(const tracer&) -> tracer& = delete;
+
+    auto set_enabled(bool enable) -> void { enabled.store(enable, std::memory_order_relaxed); }
+    auto is_enabled() const -> bool { return enabled.load(std::memory_order_relaxed); }
+
+    /// Record a span, ignored when tracing is disabled.
+    /// @param name span name
+    /// @param category span category
+    /// @param start span start
+    /// @param end span end
+    /// @param arg optional argument stored as "name" in the event args
+    auto complete(std::string name, const char* category, clock::time_point start, clock::time_point end,
+                  std::string arg = {}) -> void;
+
+    /// Number of recorded events.
+    auto size() const -> size_t;
+
+    /// Remove all recorded events.
+    auto clear() -> void;
+
+    /// Write all recorded events.
+    /// @param filename output file name
+    /// @return true if the file was written
+    auto write(const std::string& filename) const -> bool;
+
+private:
+    struct event
+    {
+        std::string name;
+        std::string arg;
+        const char* category;
+        double ts;  // microseconds since origin
+        double dur; // microseconds
+    };
+
+    struct thread_buffer
+    {
+        std::uint32_t tid;
+        std::vector<event> events;
+    };
+
+    auto local_buffer() -> thread_buffer&;
+
+    const std::uint64_t id; // unique among all tracers, used to find the thread buffer
+    const clock::time_point origin;
+    std::atomic<bool> enabled{false};
+
+    mutable std::mutex buffers_mutex;
+    std::vector<std::unique_ptr<thread_buffer>> buffers;
+};
+
+/// Records a span from construction to destruction. Does nothing if the tracer is null or disabled.
+class trace_span final
+{
+public:
+    trace_span(tracer* trc, const char* span_name, const char* span_category, std::string span_arg = {})
+        : trace(trc && trc->is_enabled() ? trc : nullptr), name(span_name), category(span_category),
+          arg(std::move(span_arg))
+    {
+        if (trace) { start = tracer::clock::now(); }
+    }
+    trace_span(const trace_span&) = delete;
+    auto operator=(const trace_span&) -> trace_span& = delete;
+
+    ~trace_span()
+    {
+        if (trace) { trace->complete(name, category, start, tracer::clock::now(), std::move(arg)); }
+    }
+
+private:
+    tracer* trace;
+    const char* name;
+    const char* category;
+    std::string arg;
+    tracer::clock::time_point start;
+};
+
+/// Tracer of the fitter currently running on this thread, used where the fitter is not reachable, e.g. formula
+/// compilation inside the entry.
+/// @return the tracer or nullptr
+auto current_tracer() -> tracer*;
+
+/// Sets the current tracer of this thread for the lifetime of the object, restores the previous one on destruction.
+class tracer_activation final
+{
+public:
+    explicit tracer_activation(tracer* trc);
+    tracer_activation(const tracer_activation&) = delete;
+    auto operator=(const tracer_activation&) -> tracer_activation& = delete;
+    ~tracer_activation();
+
+private:
+    tracer* previous;
+};
+
+} // namespace hf::detail
+
+#endif /* HELLOFITTY_TRACE_H */
@@ -0,0 +1,43 @@
+#ifndef HELLOFITTY_WATCHER_H
+#define HELLOFITTY_WATCHER_H
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hf::detail
+{
+
+/// Calls the callback on a background thread after any of the files was written, created, replaced or removed. The
+/// parent directories are watched, so the files replaced by rename, as most editors save, are still followed. Bursts
+/// of events are merged into a single call. Uses inotify and is available on Linux only.
+class file_watcher final
+{
+public:
+    /// Whether the platform supports watching.
+    static const bool supported;
+
+    /// Start watching.
+    /// @param files watched files
+    /// @param callback called on the watcher thread
+    /// @throw std::runtime_error if watching is not supported or cannot be set up
+    file_watcher(const std::vector<std::string>& files, std::function<void()> callback);
+    file_watcher(const file_watcher&) = delete;
+    auto operator=(const file_watcher&) -> file_watcher& = delete;
+    /// Stops the thread, waits for the running callback.
+    ~file_watcher();
+
+private:
+    auto run() -> void;
+
+    std::function<void()> notify;
+    std::vector<std::pair<int, std::string>> names; // watch descriptor and watched file name
+    int events_fd{-1};
+    int stop_fds[2]{-1, -1};
+    std::thread worker;
+};
+
+} // namespace hf::detail
+
+#endif /* HELLOFITTY_WATCHER_H */
@@ -24,11 +24,13 @@
 #include <RtypesCore.h>
 #include <TFitResultPtr.h>
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #if __cplusplus < 201402L
 #define CONSTEXPR
@@ -38,7 +40,9 @@
 
 class TF1;
 class TGraph;
+class TGraphErrors;
 class TH1;
+class TH2;
 
 namespace hf
 {
@@ -76,6 +80,7 @@ class HELLOFITTY_EXPORT draw_opts final
 public:
     draw_opts();
     draw_opts(const draw_opts& other);
+    auto operator=(const draw_opts& other) -> draw_opts&;
 
     /// Make function visible
     /// @param vis visibility
@@ -143,6 +148,109 @@ struct param final
     auto print() const -> void;
 };
 
+/// Minimizer selection and tuning, stored per entry. Default values defer to ROOT's default minimizer options.
+struct minimizer_opts final
+{
+    /// Minimization algorithm.
+    enum class algorithm
+    {
+        standard, ///< ROOT's default minimizer
+        migrad,   ///< Minuit2 Migrad
+        fumili2,  ///< Minuit2 Fumili2
+        gsl_lm    ///< GSL Levenberg-Marquardt
+    };
+
+    algorithm algo{algorithm::standard}; ///< Minimizer algorithm
+    int strategy{-1};                    ///< Minuit strategy, -1 for default
+    Double_t tolerance{0.0};             ///< Minimizer tolerance, 0 for default
+    int max_calls{0};                    ///< Maximal function calls, 0 for default
+
+    /// Check whether all settings defer to defaults.
+    /// @return true if nothing is customized
+    constexpr auto is_default() const -> bool
+    {
+        return algo == algorithm::standard and strategy < 0 and tolerance <= 0 and max_calls <= 0;
+    }
+};
+
+/// Limits of a single fit. A fit exceeding any of the limits is aborted, the previous parameters are restored and the
+/// entry is flagged. Zero means no limit.
+struct fit_budget final
+{
+    int max_calls{0};       ///< Maximal number of function calls
+    Double_t max_time{0.0}; ///< Maximal wall-clock time in seconds
+
+    /// Check whether any limit is set.
+    /// @return true if no limit is set
+    constexpr auto is_unlimited() const -> bool { return max_calls <= 0 and max_time <= 0; }
+};
+
+/// Outcome of the last fit of an entry, captured from the fit itself, so no second fit is needed to get the
+/// covariance. If the fit is rejected by the QA check or aborted, the old parameters are restored, the covariance is
+/// dropped and chi2 refers to the restored parameters.
+struct HELLOFITTY_EXPORT fit_result final
+{
+    int status{-1};                   ///< minimizer status, 0 on success, -1 if not fitted
+    int qa{-1};                       ///< QA check result, negative if the fit was rejected or aborted
+    Double_t edm{0.0};                ///< estimated distance to minimum
+    unsigned int ncalls{0};           ///< number of the objective function calls
+    Double_t chi2{0.0};               ///< chi2 of the final parameters
+    int ndf{0};                       ///< number of degrees of freedom
+    int npar{0};                      ///< number of parameters
+    std::vector<Double_t> covariance; ///< lower triangle packed by rows, empty if not available
+
+    /// Check whether the fit was successful and accepted.
+    /// @return true if the parameters come from this fit
+    auto is_valid() const -> bool { return status == 0 and qa >= 0; }
+
+    /// Check whether the covariance matrix is available.
+    /// @return true if the covariance was captured
+    auto has_covariance() const -> bool { return !covariance.empty(); }
+
+    /// Get the covariance matrix element, the matrix is symmetric so the order of indexes does not matter. Fixed
+    /// parameters have zero covariance.
+    /// @param i first parameter id
+    /// @param j second parameter id
+    /// @return covariance of the parameters
+    /// @throw hf::index_error if an index is incorrect or the covariance is not available
+    auto get_covariance(int i, int j) const -> Double_t;
+
+    /// Position of the element in the packed covariance.
+    /// @param i first parameter id
+    /// @param j second parameter id, not greater than i
+    /// @return index in the covariance vector
+    static constexpr auto packed_index(int i, int j) -> size_t
+    {
+        return static_cast<size_t>(i) * static_cast<size_t>(i + 1) / 2 + static_cast<size_t>(j);
+    }
+};
+
+/// Approximate memory used by entries, in bytes. Sizes of the ROOT objects are estimated from their layout and the
+/// number of parameters, heap blocks are counted without the allocator overhead.
+struct HELLOFITTY_EXPORT memory_usage final
+{
+    size_t functions{0};  ///< TF1 objects, complete and partial, with their formulas
+    size_t formulas{0};   ///< function body strings
+    size_t parameters{0}; ///< parameter and backup vectors, covariance of the last fit
+    size_t styles{0};     ///< functions style maps
+    size_t overhead{0};   ///< entry objects, registry nodes and keys
+
+    constexpr auto total() const -> size_t { return functions + formulas + parameters + styles + overhead; }
+
+    auto operator+=(const memory_usage& other) -> memory_usage&
+    {
+        functions += other.functions;
+        formulas += other.formulas;
+        parameters += other.parameters;
+        styles += other.styles;
+        overhead += other.overhead;
+        return *this;
+    }
+
+    /// Print the breakdown.
+    auto print() const -> void;
+};
+
 class fitter;
 
 namespace parser
@@ -233,11 +341,47 @@ public:
     /// Return numbers of params in total function.
     auto get_function_params_count() const -> int;
 
+    /// Set minimizer options used to fit this entry.
+    /// @param opts minimizer options
+    auto set_minimizer(minimizer_opts opts) -> void;
+    /// Get minimizer options used to fit this entry.
+    /// @return minimizer options
+    auto get_minimizer() const -> const minimizer_opts&;
+
+    /// Set the fit budget of this entry. Limits not set here are taken from the fitter budget.
+    /// @param budget fit budget
+    auto set_fit_budget(fit_budget budget) -> void;
+    /// Get the fit budget of this entry.
+    /// @return fit budget
+    auto get_fit_budget() const -> const fit_budget&;
+
+    /// Enable seeding of the initial parameters from the data before each fit. Amplitude, mean and sigma of gaus(N)
+    /// components and constant and slope of expo(N) components are estimated from the fit range. The seeds are used
+    /// only if they describe the data better than the current parameters. Fixed parameters are not changed.
+    /// @param seed enable seeding
+    auto set_auto_seed(bool seed) -> void;
+
+    /// Set the number of bins merged before the histogram fit, see TH1::Rebin().
+    /// @param rebin number of merged bins, 0 for no rebinning
+    auto set_flag_rebin(Int_t rebin) -> void;
+
     auto get_flag_rebin() const -> Int_t;
     auto get_flag_disabled() const -> bool;
+    auto get_flag_auto_seed() const -> bool;
+    /// Check whether the last fit of this entry was aborted due to exceeded budget.
+    /// @return true if the budget was exceeded
+    auto get_flag_budget_exceeded() const -> bool;
+
+    /// Get the result of the last fit of this entry: status, EDM, calls, chi2, NDF and covariance.
+    /// @return the fit result, with status -1 if the entry was not fitted yet
+    auto get_fit_result() const -> const fit_result&;
 
     auto is_valid() const -> bool;
 
+    /// Get approximate memory used by this entry.
+    /// @return memory breakdown
+    auto get_memory_usage() const -> memory_usage;
+
     auto clear() -> void;
 
     auto export_entry() const -> std::string;
@@ -270,6 +414,16 @@ enum class format_version
     v2,     ///< variable function number with params on the tail of line
 };
 
+/// Severity of the fitter messages.
+enum class log_level
+{
+    debug,   ///< details, e.g. parameters seeding
+    info,    ///< fit results and files handling
+    warning, ///< rejected fits
+    error,   ///< failures
+    off      ///< no messages
+};
+
 using params_vector = std::vector<param>;
 using fit_qa_checker =
     std::function<int(const params_vector&, double, const params_vector&, double, const TFitResultPtr&)>;
@@ -285,6 +439,177 @@ struct chi2checker
     }
 };
 
+/// Timings and outcome of a single fit.
+struct fit_record final
+{
+    /// Phases of the fit, in order of execution.
+    enum class phase
+    {
+        prepare,    ///< data seeding, entry preparation and data snapshot
+        chi2_pre,   ///< chi2 of the starting parameters
+        minimize,   ///< coarse stage and the minimizer
+        clone,      ///< copy of the fitted function attached to the data object
+        chi2_post,  ///< chi2 of the fitted parameters
+        qa,         ///< fit quality checker and restoring of the rejected parameters
+        chi2_final, ///< chi2 of the final parameters
+        propagate,  ///< propagation of the parameters to the entry and partial functions
+        attach      ///< styling and cloning of the partial functions attached to the data object
+    };
+    static constexpr size_t phases_count = 9;
+
+    std::string name;                        ///< entry name
+    std::array<double, phases_count> time{}; ///< phase wall-clock time in seconds
+    unsigned int ncalls{0};                  ///< number of the objective function calls, 0 if unknown
+    int status{-1};                          ///< minimizer status, 0 on success
+    int qa{-1};                              ///< quality checker result, -1 if rejected or aborted
+
+    /// Get the time of the phase.
+    /// @param p the phase
+    /// @return time in seconds
+    auto get(phase p) const -> double { return time[static_cast<size_t>(p)]; }
+
+    /// Get the total time of all phases.
+    /// @return time in seconds
+    auto total() const -> double;
+};
+
+/// Collection of the fit records with aggregated report.
+class HELLOFITTY_EXPORT fit_stats final
+{
+public:
+    /// Get the phase name as used in the report and CSV header.
+    /// @param p the phase
+    /// @return phase name
+    static auto phase_name(fit_record::phase p) -> const char*;
+
+    auto add(fit_record record) -> void;
+    auto clear() -> void;
+
+    auto size() const -> size_t { return records.size(); }
+    auto get_records() const -> const std::vector<fit_record>& { return records; }
+
+    /// Sum of the phase time over all fits.
+    /// @param p the phase
+    /// @return time in seconds
+    auto total(fit_record::phase p) const -> double;
+    /// Sum of the time over all fits.
+    /// @return time in seconds
+    auto total() const -> double;
+
+    /// Percentile of the phase time, using the nearest rank.
+    /// @param p the phase
+    /// @param q the percentile in range 0--100
+    /// @return time in seconds, 0 if no fits recorded
+    auto percentile(fit_record::phase p, double q) const -> double;
+    /// Percentile of the total fit time, using the nearest rank.
+    /// @param q the percentile in range 0--100
+    /// @return time in seconds, 0 if no fits recorded
+    auto percentile(double q) const -> double;
+
+    /// Get the slowest fits.
+    /// @param n number of fits
+    /// @return up to n records, sorted by total time, slowest first
+    auto slowest(size_t n) const -> std::vector<fit_record>;
+
+    /// Print summary of totals and percentiles of each phase, and the slowest fits.
+    /// @param n number of the slowest fits to print
+    auto print(size_t n = 5) const -> void;
+
+    /// Export all records as CSV, one fit per line, times in seconds.
+    /// @param filename output file name
+    /// @return true if the file was written
+    auto export_csv(const std::string& filename) const -> bool;
+
+private:
+    std::vector<fit_record> records;
+};
+
+/// Parameters of the fitted slices of a 2D histogram.
+struct HELLOFITTY_EXPORT slices_result final
+{
+    std::vector<Double_t> centers;             ///< slice bin centers
+    std::vector<Double_t> widths;              ///< slice bin widths
+    std::vector<int> status;                   ///< minimizer status per slice, 0 on success, -1 if not fitted
+    std::vector<Double_t> chi2;                ///< chi2 per slice
+    std::vector<int> ndf;                      ///< degrees of freedom per slice
+    std::vector<std::vector<Double_t>> values; ///< parameter values, indexed [parameter][slice]
+    std::vector<std::vector<Double_t>> errors; ///< parameter errors, indexed [parameter][slice]
+
+    auto slices() const -> size_t { return centers.size(); }
+
+    /// Build the trend of the parameter, only successfully fitted slices are included.
+    /// @param par_id parameter id
+    /// @return graph of the parameter value versus slice center, with errors
+    /// @throw hf::index_error if par_id is incorrect
+    auto make_graph(int par_id) const -> std::unique_ptr<TGraphErrors>;
+};
+
+/// Parameter distributions of the toy fits, see fitter::bootstrap().
+struct HELLOFITTY_EXPORT bootstrap_result final
+{
+    int nominal_status{-1};                    ///< minimizer status of the nominal fit
+    std::vector<Double_t> nominal;             ///< parameter values of the nominal fit
+    std::vector<int> status;                   ///< minimizer status per toy, 0 on success, -1 if not fitted
+    std::vector<std::vector<Double_t>> values; ///< parameter values, indexed [parameter][toy]
+
+    auto toys() const -> size_t { return status.size(); }
+
+    /// Number of successfully fitted toys, only those enter the summary quantities.
+    auto good_toys() const -> size_t;
+
+    /// Quantile of the parameter distribution, linearly interpolated between the order statistics.
+    /// @param par_id parameter id
+    /// @param q quantile in range [0, 1], clamped
+    /// @return the quantile, 0 if no toy was fitted
+    /// @throw hf::index_error if par_id is incorrect
+    auto quantile(int par_id, double q) const -> Double_t;
+    /// Mean of the parameter distribution.
+    /// @param par_id parameter id
+    /// @return the mean, 0 if no toy was fitted
+    /// @throw hf::index_error if par_id is incorrect
+    auto mean(int par_id) const -> Double_t;
+    /// Standard deviation of the parameter distribution, the bootstrap estimate of the parameter error.
+    /// @param par_id parameter id
+    /// @return the standard deviation, 0 if less than two toys were fitted
+    /// @throw hf::index_error if par_id is incorrect
+    auto std_dev(int par_id) const -> Double_t;
+
+private:
+    auto good_values(int par_id) const -> std::vector<Double_t>;
+};
+
+/// Profile of the fit statistic along one parameter, see fitter::scan().
+struct HELLOFITTY_EXPORT scan_result final
+{
+    int par_id{-1};                            ///< scanned parameter
+    int best_status{-1};                       ///< minimizer status of the unconstrained fit
+    Double_t best_value{0.0};                  ///< scanned parameter value of the unconstrained fit
+    Double_t best_objective{0.0};              ///< statistic minimum of the unconstrained fit
+    std::vector<Double_t> points;              ///< scanned parameter values
+    std::vector<Double_t> objective;           ///< statistic minimum per point, chi2 or -2 ln(likelihood ratio)
+    std::vector<int> status;                   ///< minimizer status per point, 0 on success, -1 if not fitted
+    std::vector<std::vector<Double_t>> values; ///< all parameter values per point, indexed [parameter][point]
+
+    auto size() const -> size_t { return points.size(); }
+
+    /// Build the profile curve, only successfully fitted points are included. The curve is shifted by the lowest of the
+    /// successful unconstrained fit and the points, so it starts at zero also if the unconstrained fit failed.
+    /// @return graph of the statistic minimum above the lowest minimum versus the parameter value
+    auto make_graph() const -> std::unique_ptr<TGraph>;
+};
+
+/// Link of two parameters fitted as a single parameter, see fitter::fit_combined().
+struct HELLOFITTY_EXPORT param_link final
+{
+    size_t entry_a{0}; ///< index of the first entry
+    int par_a{0};      ///< parameter of the first entry
+    size_t entry_b{0}; ///< index of the second entry
+    int par_b{0};      ///< parameter of the second entry
+};
+
+/// Registry of the fit entries and the fitting driver. All the configuration is held by the instance, so independent
+/// fitters can fit concurrently on different threads, e.g. one fitter per worker thread. ROOT must be made thread-safe
+/// first with ROOT::EnableThreadSafety(). A single fitter must not fit on two threads at the same time.
 class HELLOFITTY_EXPORT fitter final
 {
 public:
@@ -295,6 +620,28 @@ public:
         newer
     };
 
+    /// Axis of the 2D histogram along which each slice is fitted.
+    enum class slice_axis
+    {
+        x, ///< slices are y bins, fitted along x (as TH2::FitSlicesX)
+        y  ///< slices are x bins, fitted along y (as TH2::FitSlicesY)
+    };
+
+    /// Selects how the fit is performed.
+    enum class fit_engine
+    {
+        root,  ///< use TH1::Fit / TGraph::Fit
+        native ///< minimize own objective built from packed in-range bins
+    };
+
+    /// Outcome of fit_online().
+    enum class refit_status
+    {
+        skipped, ///< the histogram did not change enough since the last fit, nothing was done
+        fitted,  ///< fitted and accepted
+        failed   ///< fitted but failed or rejected, the stored parameters were restored
+    };
+
     fitter();
 
     explicit fitter(const fitter&) = delete;
@@ -331,8 +678,66 @@ public:
     /// @return true if the file was written
     auto export_to_file(bool update_reference = false) -> bool;
 
+    /// Reload the parameters given to init_from_file(), selecting the source again. If the same file is selected,
+    /// only the lines changed since the last import are parsed: entries of unchanged lines are kept as they are,
+    /// including their fitted parameters, entries of removed lines are removed, and entries inserted by the program
+    /// stay. Formulas already compiled are reused. The changes are published at once, fits running on other threads
+    /// keep the entry they started with. The file written by export_parameters() and not changed since is skipped, so
+    /// exporting while watching keeps the fit results.
+    /// @return true if the file was reloaded or skipped
+    /// @throw hf::format_error if a changed line cannot be parsed, nothing is changed then
+    auto reload() -> bool;
+    /// Watch the reference and auxiliary files and reload() them on a background thread whenever they change. Parse
+    /// errors are logged and the last good parameters are kept. Available on Linux only.
+    /// @return true if watching, false if not supported or the files cannot be watched
+    auto start_watch() -> bool;
+    /// Stop watching the files, waits for the reload in progress. Called by the destructor.
+    auto stop_watch() -> void;
+    /// Check whether the files are watched.
+    /// @return true if watching
+    auto is_watching() const -> bool;
+
+    /// Record each fit of fit(TH1*) and fit(const char*, TGraph*) in the checkpoint file: the data object name, the
+    /// fit status and the fitted entry. The records are appended, so frequent checkpoints stay cheap, and written every
+    /// interval fits. A killed process loses at most the unwritten records, see flush_checkpoint(). Call resume() to
+    /// continue the campaign of the previous run, remove the file to start a new one.
+    /// @param filename checkpoint file, the auxiliary file with ".ckpt" appended if empty
+    /// @param interval number of fits between writes, 1 writes after each fit
+    /// @throw std::logic_error if the file is not given and there is no auxiliary file
+    /// @throw std::runtime_error if the file cannot be opened; the fits and flush_checkpoint() throw it if the records
+    /// cannot be written, e.g. on a full disk, the records are kept and written with the next ones
+    auto set_checkpoint(std::string filename = {}, int interval = 1) -> void;
+    /// Restore the entries recorded in the checkpoint file and mark their fits as completed. The fits of completed
+    /// data objects are skipped: they return the recorded status and the restored entry, the data object is not
+    /// touched. Failed fits, e.g. stopped by the budget or by the kill of the job, are fitted again unless skip_failed
+    /// is set. The file is compacted to the last record of each data object.
+    /// @param skip_failed skip also the fits recorded as failed
+    /// @return number of completed fits
+    /// @throw std::logic_error if the checkpoint is not set
+    /// @throw std::runtime_error if the file cannot be compacted, the next records are appended to it as before
+    auto resume(bool skip_failed = false) -> size_t;
+    /// Check whether the fit of the data object was completed in a previous run, see resume().
+    /// @param name data object name
+    /// @return true if the fit is skipped
+    auto is_completed(const char* name) const -> bool;
+    /// Write the checkpoint records kept in memory.
+    /// @throw std::runtime_error if the records cannot be written
+    auto flush_checkpoint() -> void;
+
+    /// Find the entry for the histogram. Lookups are lock-free and may run concurrently with each other and with the
+    /// threads inserting, importing or clearing entries. A registered entry is never changed by them, a replacement is
+    /// a new entry, so the returned entry is valid until it is replaced or removed, see find_fit_shared().
+    /// @param hist histogram
+    /// @return the entry or nullptr
     auto find_fit(TH1* hist) const -> entry*;
+    /// @see find_fit(TH1*)
+    /// @param name entry name
+    /// @return the entry or nullptr
     auto find_fit(const char* name) const -> entry*;
+    /// Find the entry and share its ownership, the entry stays valid even if a writer replaces or removes it.
+    /// @param name entry name
+    /// @return the entry or empty pointer
+    auto find_fit_shared(const char* name) const -> std::shared_ptr<entry>;
 
     auto find_or_make(TH1* hist) -> entry*;
     auto find_or_make(const char* name) -> entry*;
@@ -352,6 +757,30 @@ public:
     /// @return true if fit was successful
     auto fit(entry* hfp, TH1* hist, const char* pars = "BQ", const char* gpars = "") -> bool;
 
+    /// Fit the ordered series of histograms, e.g. run-by-run or time slices, using the entries as fit(TH1*) does. Each
+    /// fit starts from the parameters of the previous fit if it succeeded and was accepted by the QA checker, and from
+    /// the stored parameters of the entry otherwise. The fixed parameters and entries with a different number of
+    /// parameters are not seeded. If the fit fails, the stored parameters are restored.
+    /// @param hists histograms to be fitted, in order
+    /// @param pars histogram fitting pars
+    /// @param gpars histogram fit drawing pars
+    /// @return pair of bool (true if fit successful) and used entry, for each histogram
+    auto fit_series(const std::vector<TH1*>& hists, const char* pars = "BQ", const char* gpars = "")
+        -> std::vector<std::pair<bool, entry*>>;
+
+    /// Fit the accumulating histogram only if it changed enough since its last fit, for online monitoring. The entry
+    /// is found as by fit(TH1*) and remembers the number of entries and the integral in the fit range at its last fit.
+    /// The fit is skipped if the relative change of the integral is below the refit threshold, or, after a failed fit,
+    /// if the histogram did not change at all. A new fit starts from the current entry parameters, which is the last
+    /// accepted result. A reset of the histogram always triggers the fit. The histogram is never modified apart from
+    /// its functions: with the rebin flag of the entry a rebinned copy is fitted, so the later fills keep the binning,
+    /// and its functions replace those of the histogram only if the fit is accepted.
+    /// @param hist histogram to be fitted
+    /// @param pars histogram fitting pars
+    /// @param gpars histogram fit drawing pars
+    /// @return pair of the refit status and used entry
+    auto fit_online(TH1* hist, const char* pars = "BQ", const char* gpars = "") -> std::pair<refit_status, entry*>;
+
     /// Fit the graph using entry either located in the collection or using generic entry if provided.
     /// @param name entry name (graphs are not named object)
     /// @param graph graph to be fitted
@@ -371,12 +800,108 @@ public:
     /// @return true if fit was successful
     auto fit(entry* hfp, const char* name, TGraph* graph, const char* pars = "BQ", const char* gpars = "") -> bool;
 
+    /// Fit the points given by plain arrays, e.g. a DAQ buffer, using provided entry. No ROOT data object is created:
+    /// the in-range points are copied into the reusable fit buffer and fitted with the native minimizer, the "L"
+    /// option selects the likelihood. QA, parameters restoring and update are the same as for the other fits, the
+    /// fitted function is available in the entry.
+    /// @param hfp entry to be used
+    /// @param name entry name used in messages and statistics
+    /// @param n number of points
+    /// @param x x values
+    /// @param y y values
+    /// @param ey y errors, unit errors if null
+    /// @param pars fitting pars
+    /// @return true if fit was successful
+    auto fit_points(entry* hfp, const char* name, size_t n, const Double_t* x, const Double_t* y,
+                    const Double_t* ey = nullptr, const char* pars = "BQ") -> bool;
+    /// Fit the histogram given by plain arrays of bins using provided entry, see fit_points(). A bin is fitted if its
+    /// center is in the entry range.
+    /// @param hfp entry to be used
+    /// @param name entry name used in messages and statistics
+    /// @param n number of bins
+    /// @param edges n+1 increasing bin edges
+    /// @param counts bin contents
+    /// @param errors bin errors, sqrt(counts) if null
+    /// @param pars fitting pars
+    /// @return true if fit was successful
+    auto fit_bins(entry* hfp, const char* name, size_t n, const Double_t* edges, const Double_t* counts,
+                  const Double_t* errors = nullptr, const char* pars = "BQ") -> bool;
+
+    /// Fit each slice of the 2D histogram with the model of the entry, e.g. each x bin projected on y. Slices are
+    /// taken directly from the histogram bins, no projection histograms are created. The slices are split into
+    /// contiguous chunks fitted in parallel; within a chunk each slice starts from the previous slice result.
+    /// Fitted with the native minimizer, the "L" option selects the likelihood.
+    /// @param hist histogram to be sliced
+    /// @param axis axis along which the slices are fitted
+    /// @param hfp entry used as model and the starting point, not modified
+    /// @param pars fitting pars
+    /// @param threads number of threads, 0 for hardware concurrency
+    /// @return the slices parameters
+    auto fit_slices(TH2* hist, slice_axis axis, const entry& hfp, const char* pars = "BQ", int threads = 0)
+        -> slices_result;
+
+    /// Estimate the parameter distributions with toy fits. The model is fitted to the histogram first (nominal fit),
+    /// then each toy resamples every bin content from the Poisson distribution with the nominal content as mean, and
+    /// is fitted starting from the nominal parameters. The toys are built in reusable buffers, no histograms are
+    /// created. Each toy has own random stream derived from the seed and the toy index, so the results do not depend
+    /// on the number of threads. Fitted with the native minimizer, the "L" option selects the likelihood.
+    /// @param hfp entry used as model and the starting point of the nominal fit, not modified
+    /// @param hist histogram to be resampled
+    /// @param n_toys number of toys
+    /// @param seed random seed
+    /// @param pars fitting pars
+    /// @param threads number of threads, 0 for hardware concurrency
+    /// @return the nominal and toy parameters
+    auto bootstrap(const entry& hfp, const TH1* hist, int n_toys, unsigned long seed, const char* pars = "BQ",
+                   int threads = 0) -> bootstrap_result;
+
+    /// Profile the fit statistic along one parameter: the parameter is fixed at each point of a regular grid and the
+    /// other parameters are refitted. The model is fitted unconstrained first. The points are split into contiguous
+    /// chunks fitted in parallel; the first point of a chunk starts from the unconstrained fit, the following ones from
+    /// the previous point. Fitted with the native minimizer, the "L" option selects the likelihood.
+    /// @param hfp entry used as model and the starting point, not modified
+    /// @param hist histogram to be fitted
+    /// @param par_id scanned parameter
+    /// @param from first grid value
+    /// @param to last grid value
+    /// @param points number of grid points
+    /// @param pars fitting pars
+    /// @param threads number of threads, 0 for hardware concurrency
+    /// @return the profile
+    /// @throw hf::index_error if par_id is incorrect
+    auto scan(const entry& hfp, const TH1* hist, int par_id, Double_t from, Double_t to, int points,
+              const char* pars = "BQ", int threads = 0) -> scan_result;
+
+    /// Fit the histograms simultaneously, with some parameters shared between the entries. One objective is built as
+    /// the sum of the entries objectives and minimized with the native minimizer; the linked parameters are a single
+    /// parameter of the minimization and take the value, limits and mode of their first occurrence. The histograms are
+    /// evaluated in parallel. The minimizer settings and the budget are taken from the first entry. On success the
+    /// parameters are written back to each entry and the functions are attached to the histograms as by fit(), the
+    /// entries fit results hold the entry chi2 and the entry block of the covariance. On failure only the fit results
+    /// are updated.
+    /// @param entries entries to be fitted, one per histogram
+    /// @param hists histograms to be fitted
+    /// @param links shared parameters, the indexes refer to entries
+    /// @param pars fitting pars
+    /// @param threads number of threads, 0 for hardware concurrency
+    /// @return fit success
+    /// @throw std::logic_error if the number of entries and histograms differ
+    /// @throw hf::index_error if a link refers to a non-existing entry or parameter
+    auto fit_combined(const std::vector<entry*>& entries, const std::vector<TH1*>& hists,
+                      const std::vector<param_link>& links, const char* pars = "BQ", int threads = 0) -> bool;
+
     auto print() const -> void;
 
-    static auto set_verbose(bool verbose) -> void;
+    /// Print the old and new parameters of each fit. Enabled by default.
+    /// @param verbose enable printing
+    auto set_verbose(bool verbose) -> void;
+    /// Check whether the per-fit messages are printed.
+    /// @return verbose mode
+    auto get_verbose() const -> bool;
 
-    /// Insert new pair of name,entry. If the entry for given name exists, update it with the
-    /// new value.
+    /// Insert new pair of name,entry. If the entry for given name exists, it is replaced by the new one; readers and
+    /// fits holding the old one keep it. The registry is copied on write, a new version shares all but O(log N) nodes
+    /// with the old one.
     /// @param name histogram name
     /// @param hfp histogram fit entry
     /// @return pointer to the registered entry
@@ -400,6 +925,86 @@ public:
 
     auto set_qa_checker(fit_qa_checker checker) -> void;
 
+    /// Set the fitting engine. The native engine takes a snapshot of the in-range bins once per fit and drives the
+    /// minimizer directly. The "L" fit option selects Poisson likelihood, otherwise chi2 is used and empty bins are
+    /// skipped. Other fit options are ignored by the native engine.
+    /// @param engine the fit engine
+    auto set_fit_engine(fit_engine engine) -> void;
+    /// Get the fitting engine.
+    /// @return the fit engine
+    auto get_fit_engine() const -> fit_engine;
+
+    /// Set the global fit budget applied to all entries. Entry budget limits take precedence. The fit is aborted as
+    /// soon as the limit is exceeded: the budgeted fits use the native engine, as TH1::Fit cannot be interrupted. Only
+    /// the entries using fumili2 or gsl_lm are fitted by ROOT, which limits the calls and checks the time afterwards.
+    /// @param budget the fit budget
+    auto set_fit_budget(fit_budget budget) -> void;
+    /// Get the global fit budget.
+    /// @return the fit budget
+    auto get_fit_budget() const -> const fit_budget&;
+
+    /// Enable coarse-to-fine fitting of histograms. Before the full fit, a copy of the in-range bins grouped by factor
+    /// is fitted and its result is used as the starting point of the full fit. The histogram is not modified.
+    /// @param factor number of bins grouped in the coarse stage, 0 or 1 disables the coarse stage
+    auto set_coarse_to_fine(int factor) -> void;
+    /// Get the coarse stage grouping factor.
+    /// @return the factor, 0 or 1 if disabled
+    auto get_coarse_to_fine() const -> int;
+
+    /// Set the threshold of fit_online(): the relative change of the histogram integral in the fit range below which
+    /// the fit is skipped. The default 0 skips only unchanged histograms.
+    /// @param threshold relative change of the integral, e.g. 0.05 to refit after 5% more entries
+    auto set_refit_threshold(Double_t threshold) -> void;
+    /// Get the threshold of fit_online().
+    /// @return the relative change of the integral
+    auto get_refit_threshold() const -> Double_t;
+
+    /// Enable recording of the per-phase timings of each fit. Disabled by default.
+    /// @param enable enable recording
+    auto set_fit_stats(bool enable) -> void;
+    /// Get the recorded fit statistics.
+    /// @return fit statistics
+    auto get_fit_stats() const -> const fit_stats&;
+    /// Remove all recorded fit statistics.
+    auto clear_fit_stats() -> void;
+
+    /// Enable recording of trace events: parameters import and export, formula compilation, and each fit broken down
+    /// by phase. Events are buffered per thread. Disabled by default.
+    /// @param enable enable recording
+    auto set_trace(bool enable) -> void;
+    /// Write the recorded events in the Chrome JSON trace format, to be opened in Perfetto or chrome://tracing. Must
+    /// not be called while fits are running.
+    /// @param filename output file name
+    /// @return true if the file was written
+    auto write_trace(const std::string& filename) const -> bool;
+    /// Remove all recorded trace events.
+    auto clear_trace() -> void;
+
+    /// Set the minimal level of the printed messages, default is info. Messages below the level are not even
+    /// formatted. The per-fit messages are printed only in the verbose mode.
+    /// @param level the log level
+    auto set_log_level(log_level level) -> void;
+    /// Get the minimal level of the printed messages.
+    /// @return the log level
+    auto get_log_level() const -> log_level;
+    /// Select whether messages are written by the background thread or directly by the calling thread (default). The
+    /// queued messages may appear out of order with the program's own output; warnings and errors are always written
+    /// directly.
+    /// @param async write in background
+    auto set_async_log(bool async) -> void;
+    /// Wait until the background thread writes all queued messages.
+    static auto flush_log() -> void;
+
+    /// Write the last fit result of each registered entry as CSV, one line per entry. The covariance column holds the
+    /// packed lower triangle separated by spaces, see hf::fit_result.
+    /// @param filename output file name
+    /// @return true if the file was written
+    auto export_results(const std::string& filename) const -> bool;
+
+    /// Get approximate memory used by all registered entries, the generic entry and the registry itself.
+    /// @return memory breakdown
+    auto get_memory_usage() const -> memory_usage;
+
 private:
     auto import_parameters(const std::string& filename) -> bool;
     auto export_parameters(const std::string& filename) -> bool;
@@ -0,0 +1,98 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HELLOFITTY_HELLOFITTY_CLIENT_H
+#define HELLOFITTY_HELLOFITTY_CLIENT_H
+
+#include <string>
+#include <vector>
+
+/// Client of the fit service, see hf::service. The client library does not depend on ROOT, so short tools using it
+/// start fast.
+
+namespace hf
+{
+
+/// Reply of the fit service to a fit request.
+struct service_reply final
+{
+    bool ok{false};             ///< request was executed, otherwise see error
+    std::string error;          ///< error message sent by the service
+    int status{-1};             ///< minimizer status, 0 on success, -1 if not fitted
+    int qa{-1};                 ///< QA check result, negative if the fit was rejected or aborted
+    double chi2{0.0};           ///< chi2 of the final parameters
+    int ndf{0};                 ///< number of degrees of freedom
+    std::vector<double> values; ///< parameter values
+    std::vector<double> errors; ///< parameter errors, 0 if the fit was rejected
+
+    /// Check whether the fit was successful and accepted, as fit_result::is_valid().
+    /// @return true if the parameters come from the fit
+    auto is_valid() const -> bool { return ok and status == 0 and qa >= 0; }
+};
+
+/// Connection to the fit service. Requests are synchronous, the client is not thread-safe; use one client per thread.
+class service_client final
+{
+public:
+    /// Connect to the service.
+    /// @param socket_path path of the service socket
+    /// @throw std::runtime_error if the connection fails
+    explicit service_client(const std::string& socket_path);
+    service_client(const service_client&) = delete;
+    auto operator=(const service_client&) -> service_client& = delete;
+    ~service_client();
+
+    /// Check whether the service responds.
+    /// @return true if the service replied
+    /// @throw std::runtime_error if the connection is broken
+    auto ping() -> bool;
+
+    /// Fit the histogram with the service entry. The entry itself is not modified by the service.
+    /// @param name entry name, without whitespaces
+    /// @param edges bin edges, one more than counts, increasing
+    /// @param counts bin contents
+    /// @param errors bin errors, empty for sqrt(counts)
+    /// @param options fitting pars, e.g. "BQ" or "LBQ" for the likelihood
+    /// @return the reply, see service_reply::ok
+    /// @throw std::runtime_error if the connection is broken
+    /// @throw std::invalid_argument if the sizes do not match
+    auto fit(const std::string& name, const std::vector<double>& edges, const std::vector<double>& counts,
+             const std::vector<double>& errors = {}, const std::string& options = "BQ") -> service_reply;
+
+    /// Fit the histogram with uniform bins.
+    /// @param name entry name, without whitespaces
+    /// @param xmin lower edge of the first bin
+    /// @param xmax upper edge of the last bin
+    /// @param counts bin contents
+    /// @param options fitting pars
+    /// @return the reply, see service_reply::ok
+    /// @throw std::runtime_error if the connection is broken
+    auto fit(const std::string& name, double xmin, double xmax, const std::vector<double>& counts,
+             const std::string& options = "BQ") -> service_reply;
+
+private:
+    /// Send the request and wait for the reply line.
+    auto request(const std::string& line) -> std::string;
+
+    int fd{-1};
+    std::string buffer;
+};
+
+} // namespace hf
+
+#endif // HELLOFITTY_HELLOFITTY_CLIENT_H
@@ -0,0 +1,72 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HELLOFITTY_HELLOFITTY_SERVICE_H
+#define HELLOFITTY_HELLOFITTY_SERVICE_H
+
+#include "hellofitty.hpp"
+
+#include <memory>
+#include <string>
+
+namespace hf
+{
+
+namespace detail
+{
+struct service_impl;
+} // namespace detail
+
+/// Resident fit service answering the fit requests of other local processes over a Unix domain socket, so that the
+/// parameter registry is loaded and the formulas are compiled once. Each request carries the histogram bins and the
+/// entry name; a copy of the entry of the fitter is fitted with the native engine and the registered entry is never
+/// changed, so the requests do not influence each other nor the other users of the fitter. Requests are served one at
+/// a time, in order of arrival. See service_client for the client side and service_protocol.hpp for the protocol.
+class HELLOFITTY_EXPORT service final
+{
+public:
+    /// @param hf_fitter fitter holding the entries, must outlive the service
+    explicit service(fitter& hf_fitter);
+    service(const service&) = delete;
+    auto operator=(const service&) -> service& = delete;
+    /// Closes the connections and removes the socket file.
+    ~service();
+
+    /// Create the socket and listen on it. A stale socket file of the same path is replaced, other files are not.
+    /// @param socket_path path of the socket file
+    /// @throw std::runtime_error if the socket cannot be created
+    auto listen(const std::string& socket_path) -> void;
+
+    /// Serve the connections until stop() is called.
+    /// @throw std::logic_error if not listening
+    auto run() -> void;
+
+    /// Make run() return after the current request. Safe to call from other threads and from signal handlers.
+    auto stop() -> void;
+
+    /// Get the number of requests served so far.
+    /// @return the number of requests
+    auto get_requests_count() const -> size_t;
+
+private:
+    std::unique_ptr<detail::service_impl> m_d;
+};
+
+} // namespace hf
+
+#endif // HELLOFITTY_HELLOFITTY_SERVICE_H
@@ -0,0 +1,222 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty.hpp"
+
+#include "details.hpp"
+#include "parallel.hpp"
+
+#include <TF1.h>
+#include <TH1.h>
+#include <TROOT.h>
+#include <TRandom3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// Seed of the toy random stream, splitmix64 of the seed and toy index, never zero which would make ROOT seed randomly.
+auto toy_seed(unsigned long seed, int toy) -> ULong64_t
+{
+    std::uint64_t z = static_cast<std::uint64_t>(seed) + 0x9e3779b97f4a7c15ull * (static_cast<std::uint64_t>(toy) + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return z ? z : 1;
+}
+
+/// Fill the toy with the contents resampled from the nominal contents, empty bins are handled as in make_bin_data().
+auto resample(const hf::detail::bin_data& nominal, TRandom& rng, hf::detail::fit_statistic stat,
+              hf::detail::bin_data& toy) -> void
+{
+    toy.clear();
+    const auto n = nominal.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        const auto content = nominal.y[i] > 0 ? static_cast<Double_t>(rng.Poisson(nominal.y[i])) : 0.0;
+        if (content <= 0 and stat == hf::detail::fit_statistic::chi2) { continue; }
+
+        toy.push_back(nominal.x[i], content, std::sqrt(content));
+    }
+}
+} // namespace
+
+namespace hf
+{
+
+auto bootstrap_result::good_toys() const -> size_t
+{
+    return static_cast<size_t>(std::count(status.begin(), status.end(), 0));
+}
+
+auto bootstrap_result::good_values(int par_id) const -> std::vector<Double_t>
+{
+    if (par_id < 0 or int2size_t(par_id) >= values.size()) { throw index_error("Parameter index out of range."); }
+
+    const auto& par_values = values[int2size_t(par_id)];
+    std::vector<Double_t> good;
+    good.reserve(par_values.size());
+    for (size_t i = 0; i < par_values.size(); ++i)
+    {
+        if (status[i] == 0) { good.push_back(par_values[i]); }
+    }
+
+    return good;
+}
+
+auto bootstrap_result::quantile(int par_id, double q) const -> Double_t
+{
+    auto good = good_values(par_id);
+    if (good.empty()) { return 0.0; }
+
+    std::sort(good.begin(), good.end());
+    const auto pos = std::clamp(q, 0.0, 1.0) * static_cast<double>(good.size() - 1);
+    const auto lower = static_cast<size_t>(pos);
+    const auto upper = std::min(lower + 1, good.size() - 1);
+
+    return good[lower] + (pos - static_cast<double>(lower)) * (good[upper] - good[lower]);
+}
+
+auto bootstrap_result::mean(int par_id) const -> Double_t
+{
+    const auto good = good_values(par_id);
+    if (good.empty()) { return 0.0; }
+
+    return std::accumulate(good.begin(), good.end(), 0.0) / static_cast<double>(good.size());
+}
+
+auto bootstrap_result::std_dev(int par_id) const -> Double_t
+{
+    const auto good = good_values(par_id);
+    if (good.size() < 2) { return 0.0; }
+
+    const auto avg = std::accumulate(good.begin(), good.end(), 0.0) / static_cast<double>(good.size());
+    const auto sum2 = std::accumulate(good.begin(), good.end(), 0.0,
+                                      [&](double sum, double v) { return sum + (v - avg) * (v - avg); });
+
+    return std::sqrt(sum2 / static_cast<double>(good.size() - 1));
+}
+
+auto fitter::bootstrap(const entry& hfp, const TH1* hist, int n_toys, unsigned long seed, const char* pars,
+                       int threads) -> bootstrap_result
+{
+    std::lock_guard<std::recursive_mutex> lock(hfp.m_d->lock.mutex);
+    const auto& model = *hfp.m_d;
+    const auto npar = model.complete_function_object.GetNpar();
+    const auto nfree = std::count_if(model.pars.begin(), model.pars.begin() + npar,
+                                     [](const param& p) { return p.mode != param::fit_mode::fixed; });
+
+    n_toys = std::max(n_toys, 0);
+
+    bootstrap_result result;
+    result.nominal.assign(int2size_t(npar), 0.0);
+    result.status.assign(int2size_t(n_toys), -1);
+    result.values.assign(int2size_t(npar), std::vector<Double_t>(int2size_t(n_toys), 0.0));
+
+    if (npar == 0) { return result; }
+
+    auto opts = model.minimizer;
+    if (detail::needs_fit_method_function(opts.algo)) { opts.algo = minimizer_opts::algorithm::standard; }
+    const auto limits = detail::merge_budget(model.budget, m_d->budget);
+    const auto stat = detail::statistic_from_option(pars);
+
+    // all the bins in range are resampled, including the empty ones
+    detail::bin_data nominal_data;
+    detail::make_bin_data(hist, model.range_min, model.range_max, detail::fit_statistic::likelihood, nominal_data);
+
+    auto start_pars = model.pars;
+    {
+        detail::trace_span span(&m_d->trace, "nominal", "fit", hist->GetName());
+
+        detail::bin_data data;
+        detail::make_bin_data(hist, model.range_min, model.range_max, stat, data);
+        if (data.size() > static_cast<size_t>(nfree))
+        {
+            auto function = model.complete_function_object;
+            try
+            {
+                const auto res = detail::minimize(function, start_pars, data, stat, opts, limits);
+                result.nominal_status = res.status;
+                result.nominal = res.values;
+            }
+            catch (const detail::budget_exceeded&)
+            {
+                // nominal fit stays not fitted
+            }
+        }
+    }
+
+    // toys start from the nominal parameters, or from the model ones if the nominal fit failed
+    if (result.nominal_status == 0)
+    {
+        for (size_t i = 0; i < int2size_t(npar); ++i)
+        {
+            if (start_pars[i].mode != param::fit_mode::fixed) { start_pars[i].value = result.nominal[i]; }
+        }
+    }
+
+    if (n_toys == 0) { return result; }
+
+    const auto chunks = detail::chunks_count(threads, n_toys);
+    if (chunks > 1) { ROOT::EnableThreadSafety(); }
+
+    // TF1 evaluation is not thread-safe, every chunk gets own copy made here, in the calling thread
+    std::vector<TF1> functions(int2size_t(chunks), model.complete_function_object);
+
+    detail::run_chunks(
+        chunks,
+        [&](int chunk)
+        {
+            auto& function = functions[int2size_t(chunk)];
+            TRandom3 rng;
+            detail::bin_data toy_data;
+
+            const auto last = detail::chunk_begin(chunk + 1, chunks, n_toys);
+            for (auto toy = detail::chunk_begin(chunk, chunks, n_toys); toy < last; ++toy)
+            {
+                detail::trace_span span(&m_d->trace, "toy", "fit", std::to_string(toy));
+
+                rng.SetSeed(toy_seed(seed, toy));
+                resample(nominal_data, rng, stat, toy_data);
+                if (toy_data.size() <= static_cast<size_t>(nfree)) { continue; }
+
+                const auto idx = int2size_t(toy);
+                try
+                {
+                    const auto res = detail::minimize(function, start_pars, toy_data, stat, opts, limits);
+                    for (size_t i = 0; i < int2size_t(npar); ++i)
+                        result.values[i][idx] = res.values[i];
+                    result.status[idx] = res.status;
+                }
+                catch (const detail::budget_exceeded&)
+                {
+                    // toy stays not fitted
+                }
+            }
+        });
+
+    return result;
+}
+
+} // namespace hf
@@ -0,0 +1,236 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "checkpoint.hpp"
+
+#include "details.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+
+namespace hf
+{
+
+namespace detail
+{
+
+checkpoint::checkpoint(std::string checkpoint_file, int records_interval)
+    : filename(std::move(checkpoint_file)), interval(std::max(records_interval, 1))
+{
+    open();
+}
+
+checkpoint::~checkpoint()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    try
+    {
+        write_pending();
+    }
+    catch (const std::runtime_error&)
+    {
+        // nobody to report to, the records are lost as with a kill
+    }
+}
+
+auto checkpoint::open() -> void
+{
+    auto torn = false;
+    {
+        std::ifstream existing(filename, std::ios::binary | std::ios::ate);
+        if (existing and existing.tellg() > 0)
+        {
+            existing.seekg(-1, std::ios::end);
+            torn = existing.get() != '\n';
+        }
+    }
+
+    file.open(filename, std::ios::binary | std::ios::app);
+    if (!file) { throw std::runtime_error("Cannot open checkpoint file " + filename); }
+
+    // the torn record of a killed run must not swallow the next one
+    if (torn) { file << '\n' << std::flush; }
+}
+
+auto checkpoint::add(const std::string& name, bool status, const entry* hfp) -> void
+{
+    auto line = fmt::format("{:c}{:s}\n", status ? '+' : '-',
+                            tools::format_line_entry(name, hfp, format_version::v2));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pending += line;
+    if (++pending_count >= interval) { write_pending(); }
+}
+
+auto checkpoint::flush() -> void
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    write_pending();
+}
+
+auto checkpoint::write_pending() -> void
+{
+    if (pending.empty()) { return; }
+
+    file << pending << std::flush;
+    if (!file)
+    {
+        // kept for the next write, e.g. after some disk space is freed; the new line ends a torn record
+        file.clear();
+        if (pending.front() != '\n') { pending.insert(0, 1, '\n'); }
+        throw std::runtime_error("Cannot write checkpoint file " + filename);
+    }
+
+    pending.clear();
+    pending_count = 0;
+}
+
+auto checkpoint::load() -> std::map<std::string, record>
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    write_pending();
+    file.close();
+
+    std::string content;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    std::map<std::string, record> records;
+    for (size_t pos = 0, end = 0; (end = content.find('\n', pos)) != std::string::npos; pos = end + 1)
+    {
+        // '+' or '-', the disabled flag of the entry, the name
+        if (end - pos < 3 or (content[pos] != '+' and content[pos] != '-')) { continue; }
+        const auto name_end = content.find_first_of(" \t", pos + 2);
+        if (name_end == std::string::npos or name_end >= end) { continue; }
+
+        records[content.substr(pos + 2, name_end - pos - 2)] =
+            record{content[pos] == '+', content.substr(pos + 1, end - pos - 1)};
+    }
+
+    // the compacted copy replaces the journal at once, a kill meanwhile leaves the old one
+    const auto temp = filename + ".tmp";
+    std::error_code error;
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        for (const auto& rec : records)
+            out << (rec.second.status ? '+' : '-') << rec.second.line << '\n';
+        out.flush();
+        if (!out) { error = std::make_error_code(std::errc::io_error); }
+    }
+    if (!error) { std::filesystem::rename(temp, filename, error); }
+
+    // reopened also on failure, the old journal is appended to then
+    open();
+    if (error)
+    {
+        std::remove(temp.c_str());
+        throw std::runtime_error("Cannot replace checkpoint file " + filename + ": " + error.message());
+    }
+
+    return records;
+}
+
+auto checkpoint::set_completed(const std::string& name, bool status) -> void
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    done[name] = status;
+}
+
+auto checkpoint::completed(const std::string& name) const -> std::optional<bool>
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = done.find(name);
+    if (it == done.end()) { return std::nullopt; }
+    return it->second;
+}
+
+} // namespace detail
+
+auto fitter::set_checkpoint(std::string filename, int interval) -> void
+{
+    if (filename.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_d->load_mutex);
+        if (m_d->par_aux.empty()) { throw std::logic_error("No auxiliary file to place the checkpoint next to."); }
+        filename = m_d->par_aux + ".ckpt";
+    }
+
+    m_d->journal.reset(); // writes the pending records of the previous checkpoint
+    m_d->journal = make_unique<detail::checkpoint>(std::move(filename), interval);
+}
+
+auto fitter::resume(bool skip_failed) -> size_t
+{
+    if (!m_d->journal) { throw std::logic_error("Checkpoint is not set."); }
+
+    std::lock_guard<std::mutex> lock(m_d->load_mutex);
+    detail::tracer_activation trace_activation(&m_d->trace);
+    detail::formula_cache_activation cache_activation(&m_d->formulas);
+
+    const auto records = m_d->journal->load();
+
+    // parsed aside and published at once, as in the import
+    std::vector<std::pair<std::string, entry>> entries;
+    size_t failed = 0;
+    for (const auto& rec : records)
+    {
+        // failed fits, e.g. aborted by the budget or by the kill, are fitted again
+        if (!rec.second.status and !skip_failed)
+        {
+            ++failed;
+            continue;
+        }
+
+        try
+        {
+            auto hfp = tools::parse_line_entry(rec.second.line, format_version::v2);
+            entries.emplace_back(tools::format_name(rec.first, m_d->name_decorator), std::move(hfp.second));
+            m_d->journal->set_completed(rec.first, rec.second.status);
+        }
+        catch (const std::exception& e)
+        {
+            m_d->log.log(log_level::warning, "Checkpoint record of {:s} skipped: {:s}\n", rec.first, e.what());
+        }
+    }
+
+    const auto resumed = entries.size();
+    m_d->hfpmap.update(std::move(entries), {});
+
+    m_d->log.log(log_level::info, "Resumed {:d} completed fits from {:s}, {:d} failed fits to retry.\n", resumed,
+                 m_d->journal->get_filename(), failed);
+
+    return resumed;
+}
+
+auto fitter::is_completed(const char* name) const -> bool
+{
+    return m_d->journal and m_d->journal->completed(name).has_value();
+}
+
+auto fitter::flush_checkpoint() -> void
+{
+    if (m_d->journal) { m_d->journal->flush(); }
+}
+
+} // namespace hf
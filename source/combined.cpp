@@ -0,0 +1,268 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty.hpp"
+
+#include "details.hpp"
+#include "parallel.hpp"
+
+#include <TF1.h>
+#include <TH1.h>
+#include <TList.h>
+#include <TROOT.h>
+
+#include <fmt/color.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace hf
+{
+
+auto fitter::fit_combined(const std::vector<entry*>& entries, const std::vector<TH1*>& hists,
+                          const std::vector<param_link>& links, const char* pars, int threads) -> bool
+{
+    if (entries.size() != hists.size()) { throw std::logic_error("Number of entries and histograms differ."); }
+
+    const auto count = entries.size();
+    if (count == 0) { return false; }
+
+    // the entries are locked in address order, so two combined fits sharing entries do not deadlock
+    auto ordered = entries;
+    std::sort(ordered.begin(), ordered.end());
+    ordered.erase(std::unique(ordered.begin(), ordered.end()), ordered.end());
+    std::vector<std::unique_lock<std::recursive_mutex>> locks;
+    locks.reserve(ordered.size());
+    for (auto* hfp : ordered)
+        locks.emplace_back(hfp->m_d->lock.mutex);
+
+    detail::trace_span span(&m_d->trace, "combined", "fit", hists.front()->GetName());
+
+    // all parameters of all entries are numbered globally, entry k starts at offsets[k]
+    std::vector<size_t> offsets(count + 1, 0);
+    for (size_t k = 0; k < count; ++k)
+        offsets[k + 1] = offsets[k] + int2size_t(entries[k]->get_function_object().GetNpar());
+    const auto total = offsets.back();
+
+    // linked parameters form groups, the root of a group is its first occurrence
+    std::vector<size_t> parent(total);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find_root = [&](size_t idx)
+    {
+        while (parent[idx] != idx)
+            idx = parent[idx] = parent[parent[idx]];
+        return idx;
+    };
+
+    auto global_index = [&](size_t entry_id, int par_id)
+    {
+        if (entry_id >= count) { throw index_error("Entry index out of range."); }
+        if (par_id < 0 or offsets[entry_id] + int2size_t(par_id) >= offsets[entry_id + 1])
+        {
+            throw index_error("Parameter index out of range.");
+        }
+        return offsets[entry_id] + int2size_t(par_id);
+    };
+
+    for (const auto& link : links)
+    {
+        const auto root_a = find_root(global_index(link.entry_a, link.par_a));
+        const auto root_b = find_root(global_index(link.entry_b, link.par_b));
+        if (root_a < root_b) { parent[root_b] = root_a; }
+        else { parent[root_a] = root_b; }
+    }
+
+    // parameters of the joint minimization
+    std::vector<size_t> joint_of(total);
+    std::vector<param> joint_pars;
+    std::vector<std::string> joint_names;
+    for (size_t k = 0; k < count; ++k)
+    {
+        const auto& model = *entries[k]->m_d;
+        for (auto i = offsets[k]; i < offsets[k + 1]; ++i)
+        {
+            const auto root = find_root(i);
+            if (root != i)
+            {
+                joint_of[i] = joint_of[root];
+                continue;
+            }
+
+            const auto par_id = size_t2int(i - offsets[k]);
+            joint_of[i] = joint_pars.size();
+            joint_pars.push_back(model.pars.at(int2size_t(par_id)));
+            joint_names.push_back(fmt::format("{}_{}", k, model.complete_function_object.GetParName(par_id)));
+        }
+    }
+
+    const auto& first = *entries.front()->m_d;
+    auto opts = first.minimizer;
+    if (detail::needs_fit_method_function(opts.algo)) { opts.algo = minimizer_opts::algorithm::standard; }
+    const auto limits = detail::merge_budget(first.budget, m_d->budget);
+    const auto stat = detail::statistic_from_option(pars);
+
+    // data snapshots, and own copies of the functions for the parallel evaluation, made here in the calling thread
+    std::vector<detail::bin_data> data(count);
+    std::vector<TF1> functions;
+    std::vector<std::vector<Double_t>> values(count);
+    functions.reserve(count);
+    size_t points = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+        const auto& model = *entries[k]->m_d;
+        detail::make_bin_data(hists[k], model.range_min, model.range_max, stat, data[k]);
+        functions.push_back(model.complete_function_object);
+        values[k].resize(offsets[k + 1] - offsets[k]);
+        points += data[k].size();
+    }
+
+    const auto nfree = std::count_if(joint_pars.begin(), joint_pars.end(),
+                                     [](const param& p) { return p.mode != param::fit_mode::fixed; });
+    if (points <= static_cast<size_t>(nfree)) { return false; }
+
+    const auto chunks = detail::chunks_count(threads, size_t2int(count));
+    if (chunks > 1) { ROOT::EnableThreadSafety(); }
+    detail::chunk_pool pool(chunks);
+
+    std::vector<Double_t> partial(count, 0.0);
+    auto joint_objective = [&](const Double_t* p) -> Double_t
+    {
+        pool.run(
+            [&](int chunk)
+            {
+                const auto last = int2size_t(detail::chunk_begin(chunk + 1, chunks, size_t2int(count)));
+                for (auto k = int2size_t(detail::chunk_begin(chunk, chunks, size_t2int(count))); k < last; ++k)
+                {
+                    auto& entry_values = values[k];
+                    for (size_t i = 0; i < entry_values.size(); ++i)
+                        entry_values[i] = p[joint_of[offsets[k] + i]];
+                    partial[k] = detail::objective(functions[k], data[k], stat, entry_values.data());
+                }
+            });
+        // summed in fixed order, the result does not depend on the number of threads
+        return std::accumulate(partial.begin(), partial.end(), 0.0);
+    };
+
+    detail::native_result res;
+    auto exceeded = false;
+    try
+    {
+        res = detail::minimize(joint_objective, joint_pars, joint_names, opts, limits);
+    }
+    catch (const detail::budget_exceeded&)
+    {
+        exceeded = true;
+    }
+
+    const auto success = !exceeded and res.status == 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+        auto* hfp = entries[k];
+        auto* hfp_m_d = hfp->m_d.get();
+        const auto npar = size_t2int(offsets[k + 1] - offsets[k]);
+        hfp_m_d->budget_exceeded = exceeded;
+
+        fit_result result;
+        result.status = exceeded ? -1 : res.status;
+        result.edm = res.edm;
+        result.ncalls = res.ncalls;
+        result.npar = npar;
+
+        if (!success)
+        {
+            hfp_m_d->result = std::move(result);
+            continue;
+        }
+
+        const auto name = hists[k]->GetName();
+        auto* tfSum = &hfp->get_function_object();
+        tfSum->SetName(tools::format_name(name, m_d->function_decorator).c_str());
+
+        std::vector<size_t> entry_free;
+        for (auto i = 0; i < npar; ++i)
+        {
+            const auto joint = joint_of[offsets[k] + int2size_t(i)];
+            const auto par = res.values[joint];
+            const auto err = res.errors[joint];
+
+            tfSum->SetParameter(i, par);
+            tfSum->SetParError(i, err);
+            for (auto function = 0; function < hfp->get_functions_count(); ++function)
+            {
+                auto& partial_function = hfp->get_function_object(function);
+                if (i < partial_function.GetNpar())
+                {
+                    partial_function.SetParameter(i, par);
+                    partial_function.SetParError(i, err);
+                }
+            }
+            hfp->update_param(i, par);
+
+            if (joint_pars[joint].mode != param::fit_mode::fixed and
+                std::find(entry_free.begin(), entry_free.end(), joint) == entry_free.end())
+            {
+                entry_free.push_back(joint);
+            }
+        }
+
+        const auto chi2 = detail::chisquare(*tfSum, data[k]);
+        tfSum->SetNDF(size_t2int(data[k].size()) - size_t2int(entry_free.size()));
+        tfSum->SetNumberFitPoints(size_t2int(data[k].size()));
+        tfSum->SetChisquare(chi2);
+
+        hists[k]->GetListOfFunctions()->Clear();
+        hists[k]->GetListOfFunctions()->SetOwner(kTRUE);
+        hists[k]->GetListOfFunctions()->Add(tfSum->Clone());
+        m_d->attach_functions(hfp, hfp_m_d, name, hists[k]);
+
+        result.qa = 1;
+        result.chi2 = chi2;
+        result.ndf = tfSum->GetNDF();
+        if (!res.covariance.empty())
+        {
+            result.covariance.reserve(fit_result::packed_index(npar, 0));
+            for (auto i = 0; i < npar; ++i)
+            {
+                const auto joint_i = size_t2int(joint_of[offsets[k] + int2size_t(i)]);
+                for (auto j = 0; j <= i; ++j)
+                {
+                    const auto joint_j = size_t2int(joint_of[offsets[k] + int2size_t(j)]);
+                    result.covariance.push_back(res.covariance[fit_result::packed_index(
+                        std::max(joint_i, joint_j), std::min(joint_i, joint_j))]);
+                }
+            }
+        }
+        hfp_m_d->result = std::move(result);
+
+        if (m_d->verbose_flag and m_d->log.enabled(log_level::info))
+        {
+            m_d->log.log(log_level::info, "{}\t [ OK ]\n",
+                         fmt::format(fmt::fg(fmt::color::lime_green),
+                                     "* comb {} ({:g}--{:g}) : {} --> chi2:  {:} -- *", name, hfp_m_d->range_min,
+                                     hfp_m_d->range_max, hfp_m_d->pars, chi2));
+        }
+    }
+
+    return success;
+}
+
+} // namespace hf
@@ -29,6 +29,12 @@ draw_opts::draw_opts() : m_d{make_unique<detail::draw_opts_impl>()} {}
 
 draw_opts::draw_opts(const draw_opts& other) : m_d{make_unique<detail::draw_opts_impl>(*other.m_d)} {}
 
+auto draw_opts::operator=(const draw_opts& other) -> draw_opts&
+{
+    *m_d = *other.m_d;
+    return *this;
+}
+
 auto draw_opts::set_visible(bool vis) -> draw_opts&
 {
     m_d->visible = vis;
@@ -44,9 +44,22 @@ template <> struct fmt::formatter<hf::entry>
     }
 };
 
+namespace
+{
+thread_local hf::detail::formula_cache* active_formula_cache{nullptr};
+} // namespace
+
 namespace hf
 {
 
+auto fit_result::get_covariance(int i, int j) const -> Double_t
+{
+    if (covariance.empty()) { throw index_error("Covariance is not available."); }
+    if (i < 0 or j < 0 or i >= npar or j >= npar) { throw index_error("Parameter index out of range."); }
+
+    return i >= j ? covariance[packed_index(i, j)] : covariance[packed_index(j, i)];
+}
+
 entry::entry() : m_d{make_unique<detail::entry_impl>()} {}
 
 entry::entry(Double_t range_lower, Double_t range_upper) : m_d{make_unique<detail::entry_impl>()}
@@ -59,7 +72,7 @@ entry::entry(const entry& other) { m_d = make_unique<detail::entry_impl>(*other.
 
 auto entry::operator=(const entry& other) -> entry&
 {
-    m_d = make_unique<detail::entry_impl>(*other.m_d);
+    if (this != &other) { m_d = make_unique<detail::entry_impl>(*other.m_d); }
     return *this;
 }
 
@@ -196,10 +209,30 @@ auto entry::clone_function(const char* new_name) -> std::unique_ptr<TF1>
 
 auto entry::get_function_params_count() const -> int { return get_function_object().GetNpar(); }
 
+auto entry::set_minimizer(minimizer_opts opts) -> void { m_d->minimizer = opts; }
+
+auto entry::get_minimizer() const -> const minimizer_opts& { return m_d->minimizer; }
+
+auto entry::set_fit_budget(fit_budget budget) -> void { m_d->budget = budget; }
+
+auto entry::get_fit_budget() const -> const fit_budget& { return m_d->budget; }
+
+auto entry::set_flag_rebin(Int_t rebin) -> void { m_d->rebin = rebin; }
+
 auto entry::get_flag_rebin() const -> int { return m_d->rebin; }
 
 auto entry::get_flag_disabled() const -> bool { return m_d->fit_disabled; }
 
+auto entry::get_memory_usage() const -> memory_usage { return detail::memory_of(*m_d); }
+
+auto entry::get_flag_budget_exceeded() const -> bool { return m_d->budget_exceeded; }
+
+auto entry::get_fit_result() const -> const fit_result& { return m_d->result; }
+
+auto entry::set_auto_seed(bool seed) -> void { m_d->auto_seed = seed; }
+
+auto entry::get_flag_auto_seed() const -> bool { return m_d->auto_seed; }
+
 auto entry::print(const std::string& name, bool detailed) const -> void
 {
     fmt::print("## name: {:s}    rebin: {:d}   range: {:g} -- {:g}  param num: {:d}  {:s}\n", name, m_d->rebin,
@@ -252,4 +285,49 @@ auto entry::set_function_style(int function_index) -> draw_opts&
 
 auto entry::set_function_style() -> draw_opts& { return set_function_style(-1); }
 
+namespace detail
+{
+
+auto formula_cache::get(const std::string& body, Double_t range_min, Double_t range_max) -> TF1
+{
+    auto it = formulas.find(body);
+    if (it == formulas.end())
+    {
+        trace_span span(current_tracer(), "compile", "formula", body);
+        it = formulas.emplace(body, TF1("", body.c_str(), range_min, range_max, TF1::EAddToList::kNo)).first;
+    }
+
+    TF1 function(it->second);
+    function.SetRange(range_min, range_max);
+    return function;
+}
+
+auto formula_cache::retain(const std::unordered_set<std::string>& bodies) -> void
+{
+    for (auto it = formulas.begin(); it != formulas.end();)
+    {
+        if (bodies.count(it->first)) { ++it; }
+        else { it = formulas.erase(it); }
+    }
+}
+
+auto current_formula_cache() -> formula_cache* { return active_formula_cache; }
+
+formula_cache_activation::formula_cache_activation(formula_cache* cache) : previous(active_formula_cache)
+{
+    active_formula_cache = cache;
+}
+
+formula_cache_activation::~formula_cache_activation() { active_formula_cache = previous; }
+
+auto make_formula(const std::string& body, Double_t range_min, Double_t range_max) -> TF1
+{
+    if (active_formula_cache) { return active_formula_cache->get(body, range_min, range_max); }
+
+    trace_span span(current_tracer(), "compile", "formula", body);
+    return TF1("", body.c_str(), range_min, range_max, TF1::EAddToList::kNo);
+}
+
+} // namespace detail
+
 } // namespace hf
@@ -0,0 +1,170 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+namespace
+{
+/// Nearest-rank percentile of unsorted values.
+auto nearest_rank(std::vector<double> values, double q) -> double
+{
+    if (values.empty()) { return 0.0; }
+
+    const auto n = values.size();
+    const auto rank = static_cast<size_t>(std::ceil(std::clamp(q, 0.0, 100.0) / 100.0 * static_cast<double>(n)));
+    const auto idx = rank > 0 ? rank - 1 : 0;
+
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(idx), values.end());
+    return values[idx];
+}
+
+auto phase_at(size_t i) -> hf::fit_record::phase { return static_cast<hf::fit_record::phase>(i); }
+} // namespace
+
+namespace hf
+{
+
+auto fit_record::total() const -> double { return std::accumulate(time.begin(), time.end(), 0.0); }
+
+auto fit_stats::phase_name(fit_record::phase p) -> const char*
+{
+    switch (p)
+    {
+        case fit_record::phase::prepare:
+            return "prepare";
+        case fit_record::phase::chi2_pre:
+            return "chi2_pre";
+        case fit_record::phase::minimize:
+            return "minimize";
+        case fit_record::phase::clone:
+            return "clone";
+        case fit_record::phase::chi2_post:
+            return "chi2_post";
+        case fit_record::phase::qa:
+            return "qa";
+        case fit_record::phase::chi2_final:
+            return "chi2_final";
+        case fit_record::phase::propagate:
+            return "propagate";
+        case fit_record::phase::attach:
+            return "attach";
+        default:
+            return "unknown";
+    }
+}
+
+auto fit_stats::add(fit_record record) -> void { records.push_back(std::move(record)); }
+
+auto fit_stats::clear() -> void { records.clear(); }
+
+auto fit_stats::total(fit_record::phase p) const -> double
+{
+    return std::accumulate(records.begin(), records.end(), 0.0,
+                           [&](double sum, const fit_record& rec) { return sum + rec.get(p); });
+}
+
+auto fit_stats::total() const -> double
+{
+    return std::accumulate(records.begin(), records.end(), 0.0,
+                           [](double sum, const fit_record& rec) { return sum + rec.total(); });
+}
+
+auto fit_stats::percentile(fit_record::phase p, double q) const -> double
+{
+    std::vector<double> values(records.size());
+    std::transform(records.begin(), records.end(), values.begin(), [&](const fit_record& rec) { return rec.get(p); });
+    return nearest_rank(std::move(values), q);
+}
+
+auto fit_stats::percentile(double q) const -> double
+{
+    std::vector<double> values(records.size());
+    std::transform(records.begin(), records.end(), values.begin(), [](const fit_record& rec) { return rec.total(); });
+    return nearest_rank(std::move(values), q);
+}
+
+auto fit_stats::slowest(size_t n) const -> std::vector<fit_record>
+{
+    std::vector<fit_record> result(records);
+    n = std::min(n, result.size());
+
+    std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(n), result.end(),
+                      [](const fit_record& a, const fit_record& b) { return a.total() > b.total(); });
+    result.resize(n);
+
+    return result;
+}
+
+auto fit_stats::print(size_t n) const -> void
+{
+    const auto fits_total = total();
+    fmt::print("Fit statistics: {:d} fits, total {:.6f} s\n", records.size(), fits_total);
+    fmt::print("{:>10s} {:>12s} {:>6s} {:>12s} {:>12s} {:>12s} {:>12s}\n", "phase", "total [s]", "%", "p50 [s]",
+               "p90 [s]", "p99 [s]", "max [s]");
+
+    for (size_t i = 0; i < fit_record::phases_count; ++i)
+    {
+        const auto p = phase_at(i);
+        const auto phase_total = total(p);
+        fmt::print("{:>10s} {:12.6f} {:6.1f} {:12.6f} {:12.6f} {:12.6f} {:12.6f}\n", phase_name(p), phase_total,
+                   fits_total > 0 ? 100.0 * phase_total / fits_total : 0.0, percentile(p, 50), percentile(p, 90),
+                   percentile(p, 99), percentile(p, 100));
+    }
+    fmt::print("{:>10s} {:12.6f} {:6.1f} {:12.6f} {:12.6f} {:12.6f} {:12.6f}\n", "all", fits_total, 100.0,
+               percentile(50), percentile(90), percentile(99), percentile(100));
+
+    const auto slow = slowest(n);
+    if (slow.empty()) { return; }
+
+    fmt::print("Slowest fits:\n");
+    for (const auto& rec : slow)
+    {
+        fmt::print("  {:s} : {:.6f} s, calls: {:d}, status: {:d}, qa: {:d}\n", rec.name, rec.total(), rec.ncalls,
+                   rec.status, rec.qa);
+    }
+}
+
+auto fit_stats::export_csv(const std::string& filename) const -> bool
+{
+    std::ofstream file(filename);
+    if (!file.is_open()) { return false; }
+
+    file << "name";
+    for (size_t i = 0; i < fit_record::phases_count; ++i)
+        file << ',' << phase_name(phase_at(i));
+    file << ",total,ncalls,status,qa\n";
+
+    for (const auto& rec : records)
+    {
+        file << '"' << rec.name << '"';
+        for (const auto t : rec.time)
+            file << fmt::format(",{:.9f}", t);
+        file << fmt::format(",{:.9f},{:d},{:d},{:d}\n", rec.total(), rec.ncalls, rec.status, rec.qa);
+    }
+
+    return file.good();
+}
+
+} // namespace hf
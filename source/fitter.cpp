@@ -24,11 +24,19 @@
 #include "details.hpp"
 #include "parser.hpp"
 
+#include <TF1.h>
 #include <TGraph.h>
 #include <TH1.h>
 #include <TList.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #if __cplusplus >= 201703L
 #include <filesystem>
@@ -36,8 +44,6 @@
 #include <sys/stat.h>
 #endif
 
-bool hf::detail::fitter_impl::verbose_flag = true;
-
 namespace
 {
 enum class source
@@ -81,6 +87,31 @@ auto select_source(const char* filename, const char* auxname = nullptr) -> sourc
 
 } // namespace
 
+namespace hf::detail
+{
+
+auto stamp_of(const std::string& filename) -> file_stamp
+{
+#if __cplusplus >= 201703L
+    std::error_code error;
+    const auto mtime = std::filesystem::last_write_time(filename, error);
+    if (error) { return {}; }
+    const auto size = std::filesystem::file_size(filename, error);
+    if (error) { return {}; }
+
+    return {static_cast<long long>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count()),
+            static_cast<long long>(size)};
+#else
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0) { return {}; }
+
+    return {(long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec, (long long)st.st_size};
+#endif
+}
+
+} // namespace hf::detail
+
 template <> struct fmt::formatter<hf::entry>
 {
     // Presentation format: 'f' - fixed, 'e' - exponential, 'g' - either.
@@ -106,65 +137,95 @@ template <> struct fmt::formatter<hf::entry>
 namespace hf
 {
 
-auto fitter::set_verbose(bool verbose) -> void { detail::fitter_impl::verbose_flag = verbose; }
-
-fitter::fitter() : m_d{make_unique<detail::fitter_impl>()} { m_d->mode = priority_mode::newer; }
-
-fitter::fitter(fitter&&) = default;
-
-auto fitter::operator=(fitter&&) -> fitter& = default;
-
-fitter::~fitter() = default;
-
-auto fitter::init_from_file(std::string filename) -> bool
+namespace detail
 {
-    m_d->par_ref = std::move(filename);
 
-    if (!m_d->par_ref.c_str()) { fmt::print(stderr, "No reference input file given\n"); }
-    if (!m_d->par_aux.c_str()) { fmt::print(stderr, "No output file given\n"); }
-
-    auto selected = select_source(m_d->par_ref.c_str(), m_d->par_aux.c_str());
+auto fitter_impl::select_file() -> std::string
+{
+    const auto selected = select_source(par_ref.c_str(), par_aux.c_str());
 
-    fmt::print("Available source: [{:c}] REF  [{:c}] AUX\n",
-               selected != source::only_auxiliary and selected != source::none ? 'x' : ' ',
-               selected != source::only_reference and selected != source::none ? 'x' : ' ');
-    fmt::print("Selected source : [{:c}] REF  [{:c}] AUX\n",
-               (selected == source::reference or selected == source::only_reference) ? 'x' : ' ',
-               (selected == source::auxiliary or selected == source::only_auxiliary) ? 'x' : ' ');
+    log.log(log_level::info,
+            "Available source: [{:c}] REF  [{:c}] AUX\n"
+            "Selected source : [{:c}] REF  [{:c}] AUX\n",
+            selected != source::only_auxiliary and selected != source::none ? 'x' : ' ',
+            selected != source::only_reference and selected != source::none ? 'x' : ' ',
+            (selected == source::reference or selected == source::only_reference) ? 'x' : ' ',
+            (selected == source::auxiliary or selected == source::only_auxiliary) ? 'x' : ' ');
 
-    if (selected == source::none) return false;
+    if (selected == source::none) return {};
 
-    if (m_d->mode == priority_mode::reference)
+    if (mode == fitter::priority_mode::reference)
     {
         if (selected == source::only_auxiliary)
-            return false;
+            return {};
         else
-            return import_parameters(m_d->par_ref);
+            return par_ref;
     }
 
-    if (m_d->mode == priority_mode::auxiliary)
+    if (mode == fitter::priority_mode::auxiliary)
     {
         if (selected == source::only_reference)
-            return false;
+            return {};
         else
-            return import_parameters(m_d->par_aux);
+            return par_aux;
     }
 
-    if (m_d->mode == priority_mode::newer)
+    if (mode == fitter::priority_mode::newer)
     {
         if (selected == source::auxiliary or selected == source::only_auxiliary)
-            return import_parameters(m_d->par_aux);
+            return par_aux;
         else if (selected == source::reference or selected == source::only_reference)
-            return import_parameters(m_d->par_ref);
+            return par_ref;
     }
 
-    return false;
+    return {};
+}
+
+auto fitter_impl::find_or_make(const char* name) -> std::shared_ptr<entry>
+{
+    auto hfp = hfpmap.find_shared(tools::format_name(name, name_decorator));
+    if (hfp) { return hfp; }
+
+    log.log(log_level::info, "HFP for {:s} not found, trying from defaults.\n", name);
+
+    if (!generic_parameters.get_functions_count()) throw std::logic_error("Generic Fit Entry has no functions.");
+
+    return hfpmap.find_or_insert(name, generic_parameters);
+}
+
+} // namespace detail
+
+auto fitter::set_verbose(bool verbose) -> void { m_d->verbose_flag = verbose; }
+
+auto fitter::get_verbose() const -> bool { return m_d->verbose_flag; }
+
+fitter::fitter() : m_d{make_unique<detail::fitter_impl>()} { m_d->mode = priority_mode::newer; }
+
+fitter::fitter(fitter&&) = default;
+
+auto fitter::operator=(fitter&&) -> fitter& = default;
+
+fitter::~fitter() = default;
+
+auto fitter::init_from_file(std::string filename) -> bool
+{
+    std::lock_guard<std::mutex> lock(m_d->load_mutex);
+    m_d->par_ref = std::move(filename);
+
+    if (!m_d->par_ref.c_str()) { m_d->log.log(log_level::error, "No reference input file given\n"); }
+    if (!m_d->par_aux.c_str()) { m_d->log.log(log_level::error, "No output file given\n"); }
+
+    const auto selected = m_d->select_file();
+    return !selected.empty() and m_d->load(selected, false);
 }
 
 auto fitter::init_from_file(std::string filename, std::string auxname, priority_mode mode) -> bool
 {
-    m_d->mode = mode;
-    m_d->par_aux = std::move(auxname);
+    {
+        std::lock_guard<std::mutex> lock(m_d->load_mutex);
+        m_d->mode = mode;
+        m_d->par_aux = std::move(auxname);
+    }
     return init_from_file(std::move(filename));
 }
 
@@ -178,10 +239,7 @@ auto fitter::export_to_file(bool update_reference) -> bool
 
 auto fitter::insert_parameter(std::pair<std::string, entry> hfp) -> entry*
 {
-    auto res = m_d->hfpmap.emplace(std::move(hfp));
-    if (!res.second) res.first->second = hfp.second;
-
-    return &res.first->second;
+    return m_d->hfpmap.insert(std::move(hfp.first), std::move(hfp.second));
 }
 
 auto fitter::insert_parameter(std::string name, entry hfp) -> entry*
@@ -191,98 +249,119 @@ auto fitter::insert_parameter(std::string name, entry hfp) -> entry*
 
 auto fitter::import_parameters(const std::string& filename) -> bool
 {
-    std::ifstream fparfile(filename.c_str());
+    std::lock_guard<std::mutex> lock(m_d->load_mutex);
+    return m_d->load(filename, false);
+}
+
+auto fitter::export_parameters(const std::string& filename) -> bool
+{
+    detail::trace_span span(&m_d->trace, "export", "io", filename);
+
+    // written aside and renamed, an interrupted export never leaves a truncated file behind
+    const auto temp = filename + ".tmp";
+    std::ofstream fparfile(temp);
     if (!fparfile.is_open())
     {
-        fmt::print(stderr, "No file {:s} to open.\n", filename);
+        m_d->log.log(log_level::error, "Can't create output file {:s}. Skipping...\n", filename);
         return false;
     }
 
-    m_d->hfpmap.clear();
-
-    std::string line;
-    while (std::getline(fparfile, line))
+    m_d->hfpmap.read(
+        [&](const detail::registry::map_type& entries)
+        {
+            m_d->log.log(log_level::info, "Output file {:s} opened...  Exporting {:d} entries.\n", filename,
+                         entries.size());
+            for (auto it = entries.begin(); it != entries.end(); ++it)
+            {
+                fparfile << tools::format_line_entry(it->first, it->second.get(), m_d->output_format_version) << '\n';
+            }
+        });
+
+    fparfile.close();
+
+    // the stamp is taken before the watcher may reload, so the reload recognizes the file written here
+    std::lock_guard<std::mutex> lock(m_d->load_mutex);
+#if __cplusplus >= 201703L
+    std::error_code error;
+    if (fparfile) { std::filesystem::rename(temp, filename, error); }
+    const auto written = fparfile and !error;
+#else
+    const auto written = fparfile and std::rename(temp.c_str(), filename.c_str()) == 0;
+#endif
+    if (!written)
     {
-        insert_parameter(tools::parse_line_entry(line, m_d->input_format_version));
+        m_d->log.log(log_level::error, "Can't write output file {:s}.\n", filename);
+        std::remove(temp.c_str());
+        m_d->exported_files.erase(filename);
+        return false;
     }
 
+    m_d->exported_files[filename] = detail::stamp_of(filename);
     return true;
 }
 
-auto fitter::export_parameters(const std::string& filename) -> bool
+auto fitter::export_results(const std::string& filename) const -> bool
 {
-    std::ofstream fparfile(filename);
-    if (!fparfile.is_open())
+    std::ofstream file(filename);
+    if (!file.is_open())
     {
-        fmt::print(stderr, "Can't create output file {:s}. Skipping...\n", filename);
+        m_d->log.log(log_level::error, "Can't create output file {:s}.\n", filename);
         return false;
     }
-    else
-    {
-        fmt::print("Output file {:s} opened...  Exporting {:d} entries.\n", filename, m_d->hfpmap.size());
-        for (auto it = m_d->hfpmap.begin(); it != m_d->hfpmap.end(); ++it)
+
+    file << "name,status,qa,edm,ncalls,chi2,ndf,npar,covariance\n";
+    m_d->hfpmap.read(
+        [&](const detail::registry::map_type& entries)
         {
-            fparfile << tools::format_line_entry(it->first, &it->second, m_d->output_format_version) << std::endl;
-        }
-    }
-    return true;
+            for (const auto& it : entries)
+            {
+                const auto& res = it.second->get_fit_result();
+                file << fmt::format("\"{:s}\",{:d},{:d},{:.10g},{:d},{:.10g},{:d},{:d},{:.10g}\n", it.first, res.status,
+                                    res.qa, res.edm, res.ncalls, res.chi2, res.ndf, res.npar,
+                                    fmt::join(res.covariance, " "));
+            }
+        });
+
+    return file.good();
 }
 
 auto fitter::find_fit(TH1* hist) const -> entry* { return find_fit(hist->GetName()); }
 
 auto fitter::find_fit(const char* name) const -> entry*
 {
-    auto it = m_d->hfpmap.find(tools::format_name(name, m_d->name_decorator));
-    if (it != m_d->hfpmap.end()) return &it->second;
-
-    return nullptr;
+    return m_d->hfpmap.find(tools::format_name(name, m_d->name_decorator));
 }
 
-auto fitter::find_or_make(TH1* hist) -> entry* { return find_or_make(hist->GetName()); }
-
-auto fitter::find_or_make(const char* name) -> entry*
+auto fitter::find_fit_shared(const char* name) const -> std::shared_ptr<entry>
 {
-    entry* hfp = find_fit(name);
-    if (!hfp)
-    {
-        // fmt::print("HFP for histogram {:s} not found, trying from defaults.\n", name);
-
-        if (!m_d->generic_parameters.get_functions_count())
-            throw std::logic_error("Generic Fit Entry has no functions.");
+    return m_d->hfpmap.find_shared(tools::format_name(name, m_d->name_decorator));
+}
 
-        hfp = insert_parameter(std::string(name), m_d->generic_parameters);
-        if (!m_d->generic_parameters.get_functions_count()) throw std::logic_error("Could not insert new parameter.");
-    }
+auto fitter::find_or_make(TH1* hist) -> entry* { return find_or_make(hist->GetName()); }
 
-    return hfp;
-}
+auto fitter::find_or_make(const char* name) -> entry* { return m_d->find_or_make(name).get(); }
 
 auto fitter::fit(TH1* hist, const char* pars, const char* gpars) -> std::pair<bool, entry*>
 {
-    entry* hfp = find_fit(hist->GetName());
-    if (!hfp)
-    {
-        fmt::print("HFP for histogram {:s} not found, trying from defaults.\n", hist->GetName());
+    const auto hfp = m_d->find_or_make(hist->GetName());
 
-        if (!m_d->generic_parameters.get_functions_count())
-            throw std::logic_error("Generic Fit Entry has no functions.");
-
-        hfp = insert_parameter(std::string(hist->GetName()), m_d->generic_parameters);
-        if (!m_d->generic_parameters.get_functions_count()) throw std::logic_error("Could not insert new parameter.");
-    }
-
-    if (!hfp) return {false, hfp};
+    const auto completed = m_d->journal ? m_d->journal->completed(hist->GetName()) : std::nullopt;
+    if (completed) { return {*completed, hfp.get()}; }
 
+    std::lock_guard<std::recursive_mutex> lock(hfp->m_d->lock.mutex);
     hfp->backup();
-    bool status = fit(hfp, hist, pars, gpars);
+    bool status = fit(hfp.get(), hist, pars, gpars);
 
     if (!status) hfp->restore();
 
-    return {status, hfp};
+    if (m_d->journal) { m_d->journal->add(hist->GetName(), status, hfp.get()); }
+
+    return {status, hfp.get()};
 }
 
 auto fitter::fit(entry* hfp, TH1* hist, const char* pars, const char* gpars) -> bool
 {
+    std::lock_guard<std::recursive_mutex> lock(hfp->m_d->lock.mutex);
     Int_t bin_l = hist->FindBin(hfp->get_fit_range_min());
     Int_t bin_u = hist->FindBin(hfp->get_fit_range_max());
 
@@ -293,35 +372,148 @@ auto fitter::fit(entry* hfp, TH1* hist, const char* pars, const char* gpars) ->
     return m_d->generic_fit(hfp, hfp->m_d.get(), hist->GetName(), hist, pars, gpars);
 }
 
-auto fitter::fit(const char* name, TGraph* graph, const char* pars, const char* gpars) -> std::pair<bool, entry*>
+auto fitter::fit_series(const std::vector<TH1*>& hists, const char* pars, const char* gpars)
+    -> std::vector<std::pair<bool, entry*>>
 {
-    entry* hfp = find_fit(name);
-    if (!hfp)
+    std::vector<std::pair<bool, entry*>> results;
+    results.reserve(hists.size());
+
+    std::vector<Double_t> previous; // parameters of the last accepted fit, empty if it failed
+    for (auto* hist : hists)
     {
-        fmt::print("HFP for graphs {:s} not found, trying from defaults.\n", name);
+        const auto hfp_ptr = m_d->find_or_make(hist->GetName());
+        auto* hfp = hfp_ptr.get();
+        std::lock_guard<std::recursive_mutex> lock(hfp->m_d->lock.mutex);
+        hfp->backup();
+
+        auto& hfp_pars = hfp->m_d->pars;
+        if (previous.size() == int2size_t(hfp->get_function_object().GetNpar()))
+        {
+            for (size_t i = 0; i < previous.size(); ++i)
+            {
+                auto& par = hfp_pars[i];
+                if (par.mode == param::fit_mode::fixed) { continue; }
+
+                par.value = par.has_limits ? std::min(std::max(previous[i], par.min), par.max) : previous[i];
+            }
+        }
 
-        if (!m_d->generic_parameters.get_functions_count())
-            throw std::logic_error("Generic Fit Entry has no functions.");
+        const auto status = fit(hfp, hist, pars, gpars);
+        const auto accepted = status and hfp->get_fit_result().is_valid();
+
+        // the rejected fit keeps the starting parameters, which may come from the previous histogram
+        if (!accepted) { hfp->restore(); }
+
+        previous.clear();
+        if (accepted)
+        {
+            for (size_t i = 0; i < int2size_t(hfp->get_function_object().GetNpar()); ++i)
+                previous.push_back(hfp_pars[i].value);
+        }
 
-        hfp = insert_parameter(std::string(name), m_d->generic_parameters);
-        if (!m_d->generic_parameters.get_functions_count()) throw std::logic_error("Could not insert new parameter.");
+        results.emplace_back(status, hfp);
     }
 
-    if (!hfp) return {false, hfp};
+    return results;
+}
+
+auto fitter::fit_online(TH1* hist, const char* pars, const char* gpars) -> std::pair<refit_status, entry*>
+{
+    const auto hfp_ptr = m_d->find_or_make(hist->GetName());
+    auto* hfp = hfp_ptr.get();
+    std::lock_guard<std::recursive_mutex> lock(hfp->m_d->lock.mutex);
+    auto& online = hfp->m_d->online;
+
+    const auto entries = hist->GetEntries();
+    const auto integral =
+        hist->Integral(hist->FindBin(hfp->get_fit_range_min()), hist->FindBin(hfp->get_fit_range_max()));
+
+    if (online.fitted and entries >= online.entries)
+    {
+        const auto change = std::abs(integral - online.integral);
+        const auto threshold = online.accepted ? m_d->refit_threshold * std::abs(online.integral) : 0.0;
+        if ((entries == online.entries and change == 0) or change < threshold) { return {refit_status::skipped, hfp}; }
+    }
 
     hfp->backup();
-    bool status = fit(hfp, name, graph, pars, gpars);
+    auto status = false;
+    if (hfp->get_flag_rebin() != 0)
+    {
+        // fit(entry*, TH1*) rebins the histogram itself, the live one would get coarser with each refit
+        std::unique_ptr<TH1> rebinned(
+            hist->Rebin(hfp->get_flag_rebin(), (std::string(hist->GetName()) + "_online_rebinned").c_str()));
+        rebinned->SetDirectory(nullptr);
+
+        const auto bin_l = rebinned->FindBin(hfp->get_fit_range_min());
+        const auto bin_u = rebinned->FindBin(hfp->get_fit_range_max());
+        status = rebinned->Integral(bin_l, bin_u) != 0 and
+                 m_d->generic_fit(hfp, hfp->m_d.get(), hist->GetName(), rebinned.get(), pars, gpars);
+
+        // the accepted fit is shown with the live histogram, replacing the functions of the previous fit; otherwise
+        // the previous ones stay
+        if (status and hfp->get_fit_result().is_valid())
+        {
+            auto* functions = hist->GetListOfFunctions();
+            functions->Delete();
+            auto* fitted = rebinned->GetListOfFunctions();
+            while (auto* function = fitted->First())
+            {
+                fitted->Remove(function);
+                if (auto* tf = dynamic_cast<TF1*>(function)) { tf->SetParent(hist); }
+                functions->Add(function);
+            }
+        }
+    }
+    else { status = fit(hfp, hist, pars, gpars); }
+
+    const auto accepted = status and hfp->get_fit_result().is_valid();
+    if (!accepted) { hfp->restore(); }
+
+    online = detail::online_state{true, accepted, entries, integral};
+
+    return {accepted ? refit_status::fitted : refit_status::failed, hfp};
+}
+
+auto fitter::fit(const char* name, TGraph* graph, const char* pars, const char* gpars) -> std::pair<bool, entry*>
+{
+    const auto hfp = m_d->find_or_make(name);
+
+    const auto completed = m_d->journal ? m_d->journal->completed(name) : std::nullopt;
+    if (completed) { return {*completed, hfp.get()}; }
+
+    std::lock_guard<std::recursive_mutex> lock(hfp->m_d->lock.mutex);
+    hfp->backup();
+    bool status = fit(hfp.get(), name, graph, pars, gpars);
 
     if (!status) hfp->restore();
 
-    return {status, hfp};
+    if (m_d->journal) { m_d->journal->add(name, status, hfp.get()); }
+
+    return {status, hfp.get()};
 }
 
 auto fitter::fit(entry* hfp, const char* name, TGraph* graph, const char* pars, const char* gpars) -> bool
 {
+    std::lock_guard<std::recursive_mutex> lock(hfp->m_d->lock.mutex);
     return m_d->generic_fit(hfp, hfp->m_d.get(), name, graph, pars, gpars);
 }
 
+auto fitter::fit_points(entry* hfp, const char* name, size_t n, const Double_t* x, const Double_t* y,
+                        const Double_t* ey, const char* pars) -> bool
+{
+    const detail::raw_points points{n, x, y, ey};
+    std::lock_guard<std::recursive_mutex> lock(hfp->m_d->lock.mutex);
+    return m_d->generic_fit(hfp, hfp->m_d.get(), name, &points, pars, "");
+}
+
+auto fitter::fit_bins(entry* hfp, const char* name, size_t n, const Double_t* edges, const Double_t* counts,
+                      const Double_t* errors, const char* pars) -> bool
+{
+    const detail::raw_bins bins{n, edges, counts, errors};
+    std::lock_guard<std::recursive_mutex> lock(hfp->m_d->lock.mutex);
+    return m_d->generic_fit(hfp, hfp->m_d.get(), name, &bins, pars, "");
+}
+
 auto fitter::set_generic_entry(entry generic) -> void { m_d->generic_parameters = generic; }
 
 auto fitter::has_generic_entry() -> bool { return m_d->generic_parameters.is_valid(); }
@@ -343,12 +535,74 @@ auto fitter::set_function_style() -> draw_opts& { return set_function_style(-1);
 
 auto fitter::set_qa_checker(fit_qa_checker checker) -> void { m_d->checker = std::move(checker); }
 
+auto fitter::set_fit_engine(fit_engine engine) -> void { m_d->engine = engine; }
+
+auto fitter::get_fit_engine() const -> fit_engine { return m_d->engine; }
+
+auto fitter::set_fit_budget(fit_budget budget) -> void { m_d->budget = budget; }
+
+auto fitter::get_fit_budget() const -> const fit_budget& { return m_d->budget; }
+
+auto fitter::set_coarse_to_fine(int factor) -> void { m_d->coarse_factor = factor; }
+
+auto fitter::get_coarse_to_fine() const -> int { return m_d->coarse_factor; }
+
+auto fitter::set_refit_threshold(Double_t threshold) -> void { m_d->refit_threshold = threshold; }
+
+auto fitter::get_refit_threshold() const -> Double_t { return m_d->refit_threshold; }
+
+auto fitter::set_fit_stats(bool enable) -> void { m_d->stats_enabled = enable; }
+
+auto fitter::get_fit_stats() const -> const fit_stats& { return m_d->stats; }
+
+auto fitter::clear_fit_stats() -> void { m_d->stats.clear(); }
+
+auto fitter::set_trace(bool enable) -> void { m_d->trace.set_enabled(enable); }
+
+auto fitter::write_trace(const std::string& filename) const -> bool { return m_d->trace.write(filename); }
+
+auto fitter::clear_trace() -> void { m_d->trace.clear(); }
+
+auto fitter::set_log_level(log_level level) -> void { m_d->log.set_level(level); }
+
+auto fitter::get_log_level() const -> log_level { return m_d->log.get_level(); }
+
+auto fitter::set_async_log(bool async) -> void { m_d->log.set_async(async); }
+
+auto fitter::flush_log() -> void { detail::log_sink::instance().flush(); }
+
+auto fitter::get_memory_usage() const -> memory_usage
+{
+    // entry shared pointer control block: vtable, use and weak counts
+    constexpr size_t control_block = sizeof(void*) + 2 * sizeof(int);
+
+    memory_usage usage;
+    m_d->hfpmap.read(
+        [&](const detail::registry::map_type& entries)
+        {
+            for (const auto& it : entries)
+            {
+                usage += it.second->get_memory_usage();
+                usage.overhead +=
+                    detail::entry_map::node_overhead + sizeof(it) + detail::memory_of(it.first) + control_block;
+            }
+        });
+
+    if (m_d->generic_parameters.get_functions_count()) { usage += m_d->generic_parameters.get_memory_usage(); }
+
+    return usage;
+}
+
 auto fitter::print() const -> void
 {
-    for (auto it = m_d->hfpmap.begin(); it != m_d->hfpmap.end(); ++it)
-    {
-        it->second.print(it->first);
-    }
+    m_d->hfpmap.read(
+        [](const detail::registry::map_type& entries)
+        {
+            for (auto it = entries.begin(); it != entries.end(); ++it)
+            {
+                it->second->print(it->first);
+            }
+        });
 }
 
 auto fitter::clear() -> void { m_d->hfpmap.clear(); }
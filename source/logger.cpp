@@ -0,0 +1,107 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "logger.hpp"
+
+#include <cstdlib>
+
+namespace hf::detail
+{
+
+auto log_sink::instance() -> log_sink&
+{
+    // leaked, so it outlives the static objects logging from their destructors
+    static auto* sink = []()
+    {
+        auto* created = new log_sink();
+        std::atexit([]() { instance().shutdown(); });
+        return created;
+    }();
+    return *sink;
+}
+
+auto log_sink::push(std::FILE* stream, std::string message) -> void
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (direct)
+    {
+        std::fputs(message.c_str(), stream);
+        return;
+    }
+    if (!worker.joinable())
+    {
+        worker = std::thread(&log_sink::run, this);
+        worker.detach();
+    }
+
+    space_cv.wait(lock, [this] { return queue.size() < max_queued; });
+    queue.emplace_back(stream, std::move(message));
+    lock.unlock();
+
+    queue_cv.notify_one();
+}
+
+auto log_sink::flush() -> void
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    drained_cv.wait(lock, [this] { return queue.empty() and !writing; });
+}
+
+auto log_sink::shutdown() -> void
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    drained_cv.wait(lock, [this] { return queue.empty() and !writing; });
+    direct = true;
+}
+
+auto log_sink::run() -> void
+{
+    std::deque<std::pair<std::FILE*, std::string>> batch;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        queue_cv.wait(lock, [this] { return !queue.empty(); });
+
+        batch.swap(queue);
+        writing = true;
+        lock.unlock();
+        space_cv.notify_all();
+
+        for (const auto& msg : batch)
+            std::fputs(msg.second.c_str(), msg.first);
+        std::fflush(stdout);
+        std::fflush(stderr);
+        batch.clear();
+
+        lock.lock();
+        writing = false;
+        if (queue.empty()) { drained_cv.notify_all(); }
+    }
+}
+
+auto logger::write(log_level lvl, std::string message) const -> void
+{
+    auto* stream = lvl >= log_level::warning ? stderr : stdout;
+
+    // warnings and errors are not queued, so they survive an abort of the process
+    if (async and lvl < log_level::warning) { log_sink::instance().push(stream, std::move(message)); }
+    else { std::fputs(message.c_str(), stream); }
+}
+
+} // namespace hf::detail
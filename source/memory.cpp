@@ -0,0 +1,107 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty.hpp"
+
+#include "details.hpp"
+
+#include <TF1.h>
+#include <TFormula.h>
+
+#include <fmt/core.h>
+
+namespace
+{
+/// TF1 with its parameters, errors and limits arrays, and the owned TFormula with expression strings and parameter
+/// names map.
+auto function_memory(const TF1& function) -> size_t
+{
+    const auto npar = int2size_t(function.GetNpar());
+
+    size_t bytes = sizeof(TF1);
+    bytes += npar * (4 * sizeof(Double_t) + sizeof(std::string)); // values, errors, limits and names
+
+    if (function.GetFormula())
+    {
+        constexpr size_t map_node = 4 * sizeof(void*) + sizeof(TString) + sizeof(int);
+        const auto expression = static_cast<size_t>(function.GetExpFormula().Length());
+
+        bytes += sizeof(TFormula) + 3 * expression; // original, processed and cling expressions
+        bytes += npar * (sizeof(Double_t) + map_node);
+    }
+
+    return bytes;
+}
+
+auto styles_memory(const std::unordered_map<int, hf::draw_opts>& styles) -> size_t
+{
+    constexpr size_t node = sizeof(void*) + sizeof(size_t) + sizeof(std::pair<const int, hf::draw_opts>) +
+                            sizeof(hf::detail::draw_opts_impl);
+    return styles.bucket_count() * sizeof(void*) + styles.size() * node;
+}
+} // namespace
+
+namespace hf
+{
+
+auto memory_usage::print() const -> void
+{
+    fmt::print("Memory usage: {:d} bytes\n"
+               "  functions:  {:d}\n"
+               "  formulas:   {:d}\n"
+               "  parameters: {:d}\n"
+               "  styles:     {:d}\n"
+               "  overhead:   {:d}\n",
+               total(), functions, formulas, parameters, styles, overhead);
+}
+
+namespace detail
+{
+
+auto memory_of(const std::string& str) -> size_t
+{
+    // short strings are stored in the object itself
+    return str.capacity() > std::string().capacity() ? str.capacity() + 1 : 0;
+}
+
+auto memory_of(const entry_impl& hfp) -> memory_usage
+{
+    memory_usage usage;
+
+    usage.functions = function_memory(hfp.complete_function_object);
+    usage.formulas = memory_of(hfp.complete_function_body);
+    for (const auto& func : hfp.funcs)
+    {
+        usage.functions += function_memory(func.function_obj);
+        usage.formulas += memory_of(func.body_string);
+    }
+
+    usage.parameters = hfp.pars.capacity() * sizeof(param) + hfp.parameters_backup.capacity() * sizeof(Double_t) +
+                       hfp.result.covariance.capacity() * sizeof(Double_t);
+    usage.styles = styles_memory(hfp.partial_functions_styles);
+
+    // the TF1 objects embedded in the entry and in the functions vector are already counted
+    usage.overhead = sizeof(entry) + sizeof(entry_impl) - sizeof(TF1) +
+                     hfp.funcs.capacity() * sizeof(function_impl) - hfp.funcs.size() * sizeof(TF1);
+
+    return usage;
+}
+
+} // namespace detail
+
+} // namespace hf
@@ -0,0 +1,405 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "objective.hpp"
+
+#include "details.hpp"
+
+#include <Math/Factory.h>
+#include <Math/Functor.h>
+#include <Math/Minimizer.h>
+#include <Math/MinimizerOptions.h>
+#include <TAxis.h>
+#include <TF1.h>
+#include <TGraph.h>
+#include <TH1.h>
+#include <TH2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace hf::detail
+{
+
+auto minimizer_defaults_mutex() -> std::shared_mutex&
+{
+    static std::shared_mutex mutex;
+    return mutex;
+}
+
+auto minimizer_names(minimizer_opts::algorithm algo) -> std::pair<std::string, std::string>
+{
+    switch (algo)
+    {
+        case minimizer_opts::algorithm::migrad:
+            return {"Minuit2", "Migrad"};
+        case minimizer_opts::algorithm::fumili2:
+            return {"Minuit2", "Fumili2"};
+        case minimizer_opts::algorithm::gsl_lm:
+            return {"GSLMultiFit", ""};
+        case minimizer_opts::algorithm::standard:
+        default:
+        {
+            std::shared_lock<std::shared_mutex> lock(minimizer_defaults_mutex());
+            return {ROOT::Math::MinimizerOptions::DefaultMinimizerType(),
+                    ROOT::Math::MinimizerOptions::DefaultMinimizerAlgo()};
+        }
+    }
+}
+
+default_minimizer_guard::default_minimizer_guard(const minimizer_opts& opts)
+{
+    if (opts.is_default())
+    {
+        shared = std::shared_lock<std::shared_mutex>(minimizer_defaults_mutex());
+        return;
+    }
+
+    exclusive = std::unique_lock<std::shared_mutex>(minimizer_defaults_mutex());
+    active = true;
+    type = ROOT::Math::MinimizerOptions::DefaultMinimizerType();
+    algo = ROOT::Math::MinimizerOptions::DefaultMinimizerAlgo();
+    strategy = ROOT::Math::MinimizerOptions::DefaultStrategy();
+    tolerance = ROOT::Math::MinimizerOptions::DefaultTolerance();
+    max_calls = ROOT::Math::MinimizerOptions::DefaultMaxFunctionCalls();
+
+    if (opts.algo != minimizer_opts::algorithm::standard)
+    {
+        const auto names = minimizer_names(opts.algo); // not the standard one, does not lock
+        ROOT::Math::MinimizerOptions::SetDefaultMinimizer(names.first.c_str(), names.second.c_str());
+    }
+    if (opts.strategy >= 0) { ROOT::Math::MinimizerOptions::SetDefaultStrategy(opts.strategy); }
+    if (opts.tolerance > 0) { ROOT::Math::MinimizerOptions::SetDefaultTolerance(opts.tolerance); }
+    if (opts.max_calls > 0) { ROOT::Math::MinimizerOptions::SetDefaultMaxFunctionCalls(opts.max_calls); }
+}
+
+default_minimizer_guard::~default_minimizer_guard()
+{
+    if (!active) { return; }
+
+    ROOT::Math::MinimizerOptions::SetDefaultMinimizer(type.c_str(), algo.c_str());
+    ROOT::Math::MinimizerOptions::SetDefaultStrategy(strategy);
+    ROOT::Math::MinimizerOptions::SetDefaultTolerance(tolerance);
+    ROOT::Math::MinimizerOptions::SetDefaultMaxFunctionCalls(max_calls);
+}
+
+auto statistic_from_option(const char* option) -> fit_statistic
+{
+    if (option and (std::strchr(option, 'L') or std::strchr(option, 'l'))) { return fit_statistic::likelihood; }
+    return fit_statistic::chi2;
+}
+
+namespace
+{
+/// First and last bin with the center in the range, as TH1::Fit selects the bins with TF1::IsInside().
+auto bins_in_range(const TAxis* axis, Double_t range_min, Double_t range_max) -> std::pair<int, int>
+{
+    auto bin_l = std::max(axis->FindFixBin(range_min), 1);
+    if (axis->GetBinCenter(bin_l) < range_min) { ++bin_l; }
+    auto bin_u = std::min(axis->FindFixBin(range_max), axis->GetNbins());
+    if (axis->GetBinCenter(bin_u) > range_max) { --bin_u; }
+    return {bin_l, bin_u};
+}
+} // namespace
+
+auto make_bin_data(const TH1* hist, Double_t range_min, Double_t range_max, fit_statistic stat, bin_data& data,
+                   int group) -> void
+{
+    data.clear();
+
+    const auto* axis = hist->GetXaxis();
+    const auto bins = bins_in_range(axis, range_min, range_max);
+    const auto bin_l = bins.first;
+    const auto bin_u = bins.second;
+    if (bin_u < bin_l) { return; }
+
+    group = std::max(group, 1);
+    data.reserve(int2size_t((bin_u - bin_l) / group + 1));
+
+    for (auto bin = bin_l; bin <= bin_u; bin += group)
+    {
+        const auto last = std::min(bin + group - 1, bin_u);
+        const auto width = static_cast<Double_t>(last - bin + 1);
+
+        Double_t content = 0.0;
+        Double_t error2 = 0.0;
+        for (auto b = bin; b <= last; ++b)
+        {
+            content += hist->GetBinContent(b);
+            const auto error = hist->GetBinError(b);
+            error2 += error * error;
+        }
+
+        if (error2 <= 0 and stat == fit_statistic::chi2) { continue; }
+
+        const auto center = 0.5 * (axis->GetBinLowEdge(bin) + axis->GetBinUpEdge(last));
+        data.push_back(center, content / width, error2 > 0 ? std::sqrt(error2) / width : 0.0);
+    }
+}
+
+auto make_bin_data(const TGraph* graph, Double_t range_min, Double_t range_max, fit_statistic /*stat*/,
+                   bin_data& data, int /*group*/) -> void
+{
+    data.clear();
+
+    const auto n = graph->GetN();
+    const auto* px = graph->GetX();
+    const auto* py = graph->GetY();
+
+    data.reserve(int2size_t(n));
+
+    for (auto i = 0; i < n; ++i)
+    {
+        if (px[i] < range_min or px[i] > range_max) { continue; }
+
+        const auto error = graph->GetErrorY(i);
+        data.push_back(px[i], py[i], error > 0 ? error : 1.0);
+    }
+}
+
+auto make_bin_data(const raw_points* points, Double_t range_min, Double_t range_max, fit_statistic /*stat*/,
+                   bin_data& data, int /*group*/) -> void
+{
+    data.clear();
+    data.reserve(points->n);
+
+    for (size_t i = 0; i < points->n; ++i)
+    {
+        const auto px = points->x[i];
+        if (px < range_min or px > range_max) { continue; }
+
+        const auto error = points->ey ? points->ey[i] : 0.0;
+        data.push_back(px, points->y[i], error > 0 ? error : 1.0);
+    }
+}
+
+auto make_bin_data(const raw_bins* bins, Double_t range_min, Double_t range_max, fit_statistic stat, bin_data& data,
+                   int group) -> void
+{
+    data.clear();
+
+    const auto* edges = bins->edges;
+    const auto n = bins->n;
+
+    // first and last bin with the center in the range
+    size_t bin_l = 0;
+    while (bin_l < n and 0.5 * (edges[bin_l] + edges[bin_l + 1]) < range_min)
+        ++bin_l;
+    auto bin_u = bin_l;
+    while (bin_u < n and 0.5 * (edges[bin_u] + edges[bin_u + 1]) <= range_max)
+        ++bin_u;
+    if (bin_u == bin_l) { return; }
+
+    const auto step = int2size_t(std::max(group, 1));
+    data.reserve((bin_u - bin_l) / step + 1);
+
+    for (auto bin = bin_l; bin < bin_u; bin += step)
+    {
+        const auto last = std::min(bin + step, bin_u);
+        const auto width = static_cast<Double_t>(last - bin);
+
+        Double_t content = 0.0;
+        Double_t error2 = 0.0;
+        for (auto b = bin; b < last; ++b)
+        {
+            content += bins->counts[b];
+            error2 += bins->errors ? bins->errors[b] * bins->errors[b] : std::max(bins->counts[b], 0.0);
+        }
+
+        if (error2 <= 0 and stat == fit_statistic::chi2) { continue; }
+
+        const auto center = 0.5 * (edges[bin] + edges[last]);
+        data.push_back(center, content / width, error2 > 0 ? std::sqrt(error2) / width : 0.0);
+    }
+}
+
+auto make_slice_data(const TH2* hist, int slice, bool along_x, Double_t range_min, Double_t range_max,
+                     fit_statistic stat, bin_data& data) -> void
+{
+    data.clear();
+
+    const auto* axis = along_x ? hist->GetXaxis() : hist->GetYaxis();
+    const auto bins = bins_in_range(axis, range_min, range_max);
+    const auto bin_l = bins.first;
+    const auto bin_u = bins.second;
+    if (bin_u < bin_l) { return; }
+
+    data.reserve(int2size_t(bin_u - bin_l + 1));
+
+    for (auto bin = bin_l; bin <= bin_u; ++bin)
+    {
+        const auto content = along_x ? hist->GetBinContent(bin, slice) : hist->GetBinContent(slice, bin);
+        const auto error = along_x ? hist->GetBinError(bin, slice) : hist->GetBinError(slice, bin);
+
+        if (error <= 0 and stat == fit_statistic::chi2) { continue; }
+
+        data.push_back(axis->GetBinCenter(bin), content, error > 0 ? error : 0.0);
+    }
+}
+
+auto chisquare(TF1& function, const bin_data& data) -> Double_t
+{
+    const auto* pars = function.GetParameters();
+    const auto n = data.size();
+
+    Double_t chi2 = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (data.ey[i] <= 0) { continue; }
+
+        const auto residual = (data.y[i] - function.EvalPar(&data.x[i], pars)) / data.ey[i];
+        chi2 += residual * residual;
+    }
+
+    return chi2;
+}
+
+auto objective(TF1& function, const bin_data& data, fit_statistic stat, const Double_t* pars) -> Double_t
+{
+    const auto n = data.size();
+    Double_t sum = 0.0;
+
+    if (stat == fit_statistic::chi2)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto residual = (data.y[i] - function.EvalPar(&data.x[i], pars)) / data.ey[i];
+            sum += residual * residual;
+        }
+    }
+    else
+    {
+        constexpr Double_t min_expected = 1e-300;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto expected = std::max(function.EvalPar(&data.x[i], pars), min_expected);
+            const auto observed = data.y[i];
+
+            sum += expected - observed;
+            if (observed > 0) { sum += observed * std::log(observed / expected); }
+        }
+        sum *= 2.0;
+    }
+
+    return sum;
+}
+
+auto minimize(TF1& function, const std::vector<param>& pars, const bin_data& data, fit_statistic stat,
+              const minimizer_opts& opts, const fit_budget& budget) -> native_result
+{
+    const auto npar = int2size_t(function.GetNpar());
+
+    std::vector<param> function_pars;
+    std::vector<std::string> names;
+    function_pars.reserve(npar);
+    names.reserve(npar);
+    for (size_t i = 0; i < npar; ++i)
+    {
+        function_pars.push_back(pars.at(i));
+        names.emplace_back(function.GetParName(size_t2int(i)));
+    }
+
+    return minimize([&](const Double_t* p) { return objective(function, data, stat, p); }, function_pars, names, opts,
+                    budget);
+}
+
+auto minimize(const objective_function& fcn, const std::vector<param>& pars, const std::vector<std::string>& par_names,
+              const minimizer_opts& opts, const fit_budget& budget) -> native_result
+{
+    const auto names = minimizer_names(opts.algo);
+    std::unique_ptr<ROOT::Math::Minimizer> minimizer;
+    {
+        // the minimizer reads the global defaults when created
+        std::shared_lock<std::shared_mutex> lock(minimizer_defaults_mutex());
+        minimizer.reset(ROOT::Math::Factory::CreateMinimizer(names.first, names.second));
+    }
+    if (!minimizer) { throw std::runtime_error(fmt::format("Could not create the {} minimizer.", names.first)); }
+
+    if (opts.strategy >= 0) { minimizer->SetStrategy(opts.strategy); }
+    if (opts.tolerance > 0) { minimizer->SetTolerance(opts.tolerance); }
+    if (opts.max_calls > 0) { minimizer->SetMaxFunctionCalls(static_cast<unsigned int>(opts.max_calls)); }
+
+    const auto npar = size_t2int(pars.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    auto calls = 0;
+
+    ROOT::Math::Functor functor(
+        [&](const Double_t* p)
+        {
+            if (budget.max_calls > 0 and ++calls > budget.max_calls)
+            {
+                throw budget_exceeded(fmt::format("Exceeded {} function calls", budget.max_calls));
+            }
+            if (budget.max_time > 0 and
+                std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count() > budget.max_time)
+            {
+                throw budget_exceeded(fmt::format("Exceeded {:g} s fit time", budget.max_time));
+            }
+            return fcn(p);
+        },
+        static_cast<unsigned int>(npar));
+    minimizer->SetFunction(functor);
+    minimizer->SetErrorDef(1.0);
+    minimizer->SetPrintLevel(0);
+
+    for (auto i = 0; i < npar; ++i)
+    {
+        const auto& par = pars[int2size_t(i)];
+        const auto& name = par_names.at(int2size_t(i));
+        const auto idx = static_cast<unsigned int>(i);
+        const auto step = par.value != 0 ? 0.1 * std::abs(par.value) : 0.1;
+
+        if (par.mode == hf::param::fit_mode::fixed)
+        {
+            minimizer->SetFixedVariable(idx, name, par.value);
+        }
+        else if (par.has_limits)
+        {
+            minimizer->SetLimitedVariable(idx, name, par.value, step, par.min, par.max);
+        }
+        else { minimizer->SetVariable(idx, name, par.value, step); }
+    }
+
+    native_result result;
+    minimizer->Minimize();
+
+    result.status = minimizer->Status();
+    result.fval = minimizer->MinValue();
+    result.edm = minimizer->Edm();
+    result.ncalls = minimizer->NCalls();
+    result.nfree = minimizer->NFree();
+    result.values.assign(minimizer->X(), minimizer->X() + npar);
+    if (minimizer->Errors()) { result.errors.assign(minimizer->Errors(), minimizer->Errors() + npar); }
+    else { result.errors.assign(int2size_t(npar), 0.0); }
+
+    if (minimizer->Errors() and minimizer->CovMatrixStatus() > 0)
+    {
+        result.covariance.reserve(fit_result::packed_index(npar, 0));
+        for (auto i = 0; i < npar; ++i)
+            for (auto j = 0; j <= i; ++j)
+                result.covariance.push_back(
+                    minimizer->CovMatrix(static_cast<unsigned int>(i), static_cast<unsigned int>(j)));
+    }
+
+    return result;
+}
+
+} // namespace hf::detail
@@ -8,10 +8,92 @@
 #include <TObjString.h>
 #include <TString.h>
 
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
 #include <memory>
 
 #include <fmt/core.h>
 
+namespace
+{
+auto parse_minimizer_algorithm(const std::string& value) -> hf::minimizer_opts::algorithm
+{
+    if (value == "migrad") { return hf::minimizer_opts::algorithm::migrad; }
+    if (value == "fumili2") { return hf::minimizer_opts::algorithm::fumili2; }
+    if (value == "gsl_lm") { return hf::minimizer_opts::algorithm::gsl_lm; }
+    if (value == "standard") { return hf::minimizer_opts::algorithm::standard; }
+
+    throw hf::format_error(fmt::format("Unknown minimizer {}", value));
+}
+
+auto format_minimizer_algorithm(hf::minimizer_opts::algorithm algo) -> const char*
+{
+    switch (algo)
+    {
+        case hf::minimizer_opts::algorithm::migrad:
+            return "migrad";
+        case hf::minimizer_opts::algorithm::fumili2:
+            return "fumili2";
+        case hf::minimizer_opts::algorithm::gsl_lm:
+            return "gsl_lm";
+        default:
+            return "standard";
+    }
+}
+
+/// Parse integer value of the option token
+/// @throw hf::format_error if the value is not an integer within the limits
+auto parse_option_int(const std::string& token, const std::string& value, long min, long max) -> int
+{
+    errno = 0;
+    char* end = nullptr;
+    const auto number = std::strtol(value.c_str(), &end, 10);
+    if (end != value.c_str() + value.size() or errno == ERANGE or number < min or number > max)
+    {
+        throw hf::format_error(fmt::format("Invalid value in option {}", token));
+    }
+    return static_cast<int>(number);
+}
+
+/// Parse non-negative floating point value of the option token
+/// @throw hf::format_error if the value is not a finite non-negative number
+auto parse_option_double(const std::string& token, const std::string& value) -> Double_t
+{
+    errno = 0;
+    char* end = nullptr;
+    const auto number = std::strtod(value.c_str(), &end);
+    if (end != value.c_str() + value.size() or errno == ERANGE or !std::isfinite(number) or number < 0)
+    {
+        throw hf::format_error(fmt::format("Invalid value in option {}", token));
+    }
+    return number;
+}
+
+/// Parse single key=value option token
+auto parse_option_token(const std::string& token, hf::minimizer_opts& opts, hf::fit_budget& budget, bool& seed) -> void
+{
+    const auto sep = token.find('=');
+    if (sep == std::string::npos or sep == 0 or sep + 1 == token.size())
+    {
+        throw hf::format_error(fmt::format("Ill-formed option {}", token));
+    }
+
+    const auto key = token.substr(0, sep);
+    const auto value = token.substr(sep + 1);
+
+    if (key == "minimizer") { opts.algo = parse_minimizer_algorithm(value); }
+    else if (key == "strategy") { opts.strategy = parse_option_int(token, value, 0, 2); }
+    else if (key == "tolerance") { opts.tolerance = parse_option_double(token, value); }
+    else if (key == "calls") { opts.max_calls = parse_option_int(token, value, 0, INT_MAX); }
+    else if (key == "budget_calls") { budget.max_calls = parse_option_int(token, value, 0, INT_MAX); }
+    else if (key == "budget_time") { budget.max_time = parse_option_double(token, value); }
+    else if (key == "seed") { seed = parse_option_int(token, value, 0, 1) != 0; }
+    else { throw hf::format_error(fmt::format("Unknown option {}", token)); }
+}
+} // namespace
+
 namespace hf::parser
 {
 auto v2::parse_line_entry(const std::string& line) -> std::pair<std::string, entry>
@@ -60,7 +142,14 @@ auto v2::parse_line_entry(const std::string& line) -> std::pair<std::string, ent
     auto params_count = hfp.get_function_params_count();
     auto current_param = 0;
 
-    for (int i = token_id + 1; i < all_tokens; i += step)
+    // optional entry options follow the second '|' marker
+    auto options_id = token_id + 1;
+    for (; options_id < all_tokens; ++options_id)
+    {
+        if (dynamic_cast<TObjString*>(arr->At(options_id))->String() == "|") { break; }
+    }
+
+    for (int i = token_id + 1; i < options_id; i += step)
     {
         if (current_param > params_count) { throw hf::format_error(fmt::format("To many parameters in {}", name)); }
 
@@ -70,21 +159,21 @@ auto v2::parse_line_entry(const std::string& line) -> std::pair<std::string, ent
 
         const TString val = dynamic_cast<TObjString*>(arr->At(i))->String();
         const TString nval =
-            ((i + 1) < arr->GetEntries()) ? dynamic_cast<TObjString*>(arr->At(i + 1))->String() : TString();
+            ((i + 1) < options_id) ? dynamic_cast<TObjString*>(arr->At(i + 1))->String() : TString();
 
         auto par_ = val.Atof();
         if (nval == ":")
         {
-            l_ = (i + 2) < arr->GetEntries() ? dynamic_cast<TObjString*>(arr->At(i + 2))->String().Atof() : 0;
-            u_ = (i + 2) < arr->GetEntries() ? dynamic_cast<TObjString*>(arr->At(i + 3))->String().Atof() : 0;
+            l_ = (i + 2) < options_id ? dynamic_cast<TObjString*>(arr->At(i + 2))->String().Atof() : 0;
+            u_ = (i + 3) < options_id ? dynamic_cast<TObjString*>(arr->At(i + 3))->String().Atof() : 0;
             step = 4;
             flag_ = param::fit_mode::free;
             has_limits_ = true;
         }
         else if (nval == "F")
         {
-            l_ = (i + 2) < arr->GetEntries() ? dynamic_cast<TObjString*>(arr->At(i + 2))->String().Atof() : 0;
-            u_ = (i + 2) < arr->GetEntries() ? dynamic_cast<TObjString*>(arr->At(i + 3))->String().Atof() : 0;
+            l_ = (i + 2) < options_id ? dynamic_cast<TObjString*>(arr->At(i + 2))->String().Atof() : 0;
+            u_ = (i + 3) < options_id ? dynamic_cast<TObjString*>(arr->At(i + 3))->String().Atof() : 0;
             step = 4;
             flag_ = param::fit_mode::fixed;
             has_limits_ = true;
@@ -119,6 +208,17 @@ auto v2::parse_line_entry(const std::string& line) -> std::pair<std::string, ent
         current_param++;
     }
 
+    minimizer_opts opts;
+    fit_budget budget;
+    bool seed{false};
+    for (int i = options_id + 1; i < all_tokens; ++i)
+    {
+        parse_option_token(dynamic_cast<TObjString*>(arr->At(i))->String().Data(), opts, budget, seed);
+    }
+    hfp.set_minimizer(opts);
+    hfp.set_fit_budget(budget);
+    hfp.set_auto_seed(seed);
+
     return std::make_pair(std::move(name), std::move(hfp));
 }
 
@@ -168,6 +268,23 @@ auto v2::format_line_entry(const std::string& name, const hf::entry* hist_fit) -
         }
     }
 
+    const auto& opts = hist_fit->get_minimizer();
+    const auto& budget = hist_fit->get_fit_budget();
+    if (!opts.is_default() or !budget.is_unlimited() or hist_fit->get_flag_auto_seed())
+    {
+        out += " |";
+        if (opts.algo != minimizer_opts::algorithm::standard)
+        {
+            out += fmt::format(" minimizer={:s}", format_minimizer_algorithm(opts.algo));
+        }
+        if (opts.strategy >= 0) { out += fmt::format(" strategy={:d}", opts.strategy); }
+        if (opts.tolerance > 0) { out += fmt::format(" tolerance={}", opts.tolerance); }
+        if (opts.max_calls > 0) { out += fmt::format(" calls={:d}", opts.max_calls); }
+        if (budget.max_calls > 0) { out += fmt::format(" budget_calls={:d}", budget.max_calls); }
+        if (budget.max_time > 0) { out += fmt::format(" budget_time={}", budget.max_time); }
+        if (hist_fit->get_flag_auto_seed()) { out += " seed=1"; }
+    }
+
     return out;
 }
 } // namespace hf::parser
@@ -0,0 +1,372 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "registry.hpp"
+
+#include "details.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+std::atomic<std::uint64_t> next_registry_id{1};
+} // namespace
+
+namespace hf::detail
+{
+
+struct entry_map::node
+{
+    value_type value;
+    size_t priority; // hash of the name, greater priorities are closer to the root
+    node_ptr left;
+    node_ptr right;
+};
+
+// the node and its shared pointer control block: vtable, use and weak counts
+const size_t entry_map::node_overhead =
+    sizeof(entry_map::node) - sizeof(entry_map::value_type) + sizeof(void*) + 2 * sizeof(int);
+
+auto entry_map::const_iterator::operator*() const -> reference { return path.back()->value; }
+
+auto entry_map::const_iterator::operator++() -> const_iterator&
+{
+    const auto* current = path.back();
+    path.pop_back();
+    descend(current->right.get());
+    return *this;
+}
+
+auto entry_map::const_iterator::operator++(int) -> const_iterator
+{
+    auto old = *this;
+    ++*this;
+    return old;
+}
+
+auto entry_map::const_iterator::descend(const node* n) -> void
+{
+    for (; n; n = n->left.get())
+        path.push_back(n);
+}
+
+auto entry_map::begin() const -> const_iterator
+{
+    const_iterator it;
+    it.descend(root.get());
+    return it;
+}
+
+auto entry_map::find(const std::string& name) const -> const_iterator
+{
+    const_iterator it;
+    for (const auto* n = root.get(); n;)
+    {
+        if (name < n->value.first)
+        {
+            it.path.push_back(n);
+            n = n->left.get();
+        }
+        else if (n->value.first < name) { n = n->right.get(); }
+        else
+        {
+            it.path.push_back(n);
+            return it;
+        }
+    }
+    return end();
+}
+
+auto entry_map::insert(std::string name, std::shared_ptr<entry> hfp) const -> entry_map
+{
+    const auto priority = std::hash<std::string>()(name);
+    auto added = std::make_shared<const node>(node{{std::move(name), std::move(hfp)}, priority, nullptr, nullptr});
+
+    const auto& key = added->value.first;
+    if (find(key) != end()) { return {insert(erase(root, key), std::move(added)), count}; }
+    return {insert(root, std::move(added)), count + 1};
+}
+
+auto entry_map::erase(const std::string& name) const -> entry_map
+{
+    if (find(name) == end()) { return *this; }
+    return {erase(root, name), count - 1};
+}
+
+namespace
+{
+template <class Node, class Ptr> auto with_children(const Node& n, Ptr left, Ptr right) -> Ptr
+{
+    return std::make_shared<const Node>(Node{n.value, n.priority, std::move(left), std::move(right)});
+}
+} // namespace
+
+auto entry_map::split(const node_ptr& tree, const std::string& name) -> std::pair<node_ptr, node_ptr>
+{
+    if (!tree) { return {}; }
+
+    if (tree->value.first < name)
+    {
+        auto parts = split(tree->right, name);
+        return {with_children(*tree, tree->left, std::move(parts.first)), std::move(parts.second)};
+    }
+
+    auto parts = split(tree->left, name);
+    return {std::move(parts.first), with_children(*tree, std::move(parts.second), tree->right)};
+}
+
+auto entry_map::merge(const node_ptr& left, const node_ptr& right) -> node_ptr
+{
+    if (!left) { return right; }
+    if (!right) { return left; }
+
+    if (left->priority > right->priority) { return with_children(*left, left->left, merge(left->right, right)); }
+    return with_children(*right, merge(left, right->left), right->right);
+}
+
+auto entry_map::insert(const node_ptr& tree, node_ptr added) -> node_ptr
+{
+    if (!tree) { return added; }
+
+    if (added->priority > tree->priority)
+    {
+        auto parts = split(tree, added->value.first);
+        return with_children(*added, std::move(parts.first), std::move(parts.second));
+    }
+
+    if (added->value.first < tree->value.first)
+    {
+        return with_children(*tree, insert(tree->left, std::move(added)), tree->right);
+    }
+    return with_children(*tree, tree->left, insert(tree->right, std::move(added)));
+}
+
+auto entry_map::erase(const node_ptr& tree, const std::string& name) -> node_ptr
+{
+    if (!tree) { return nullptr; }
+
+    if (name < tree->value.first) { return with_children(*tree, erase(tree->left, name), tree->right); }
+    if (tree->value.first < name) { return with_children(*tree, tree->left, erase(tree->right, name)); }
+    return merge(tree->left, tree->right);
+}
+
+
+registry::registry() : id(next_registry_id.fetch_add(1, std::memory_order_relaxed)), current(new map_type()) {}
+
+registry::~registry()
+{
+    delete current.load();
+    for (const auto& old : retired)
+        delete old.second;
+}
+
+auto registry::local_slot() const -> reader_slot&
+{
+    // the slots of the thread, released on its exit for the next threads reading the registry
+    struct thread_slots
+    {
+        ~thread_slots()
+        {
+            for (const auto& slot : slots)
+                slot.second->owned.store(false, std::memory_order_release);
+        }
+
+        std::unordered_map<std::uint64_t, std::shared_ptr<reader_slot>> slots;
+    };
+    thread_local thread_slots local_slots;
+
+    // registry ids are never reused, so a stale entry of a destroyed registry is never hit
+    auto it = local_slots.slots.find(id);
+    if (it != local_slots.slots.end()) { return *it->second; }
+
+    // the slots of the destroyed registries are owned by this thread only
+    for (auto stale = local_slots.slots.begin(); stale != local_slots.slots.end();)
+    {
+        if (stale->second.use_count() == 1) { stale = local_slots.slots.erase(stale); }
+        else { ++stale; }
+    }
+
+    std::shared_ptr<reader_slot> slot;
+    {
+        std::lock_guard<std::mutex> lock(slots_mutex);
+        for (const auto& free : slots)
+        {
+            auto owned = false;
+            if (free->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+            {
+                slot = free;
+                break;
+            }
+        }
+
+        if (!slot)
+        {
+            slot = std::make_shared<reader_slot>();
+            slots.push_back(slot);
+        }
+    }
+
+    return *local_slots.slots.emplace(id, std::move(slot)).first->second;
+}
+
+registry::read_section::read_section(const registry& reg) : slot(reg.local_slot()), map(nullptr)
+{
+    // announce the epoch before loading the map, the writer reclaiming concurrently either sees the announcement or
+    // has already published the new version which is then loaded here
+    if (slot.depth++ == 0) { slot.epoch.store(reg.epoch.load()); }
+    map = reg.current.load();
+}
+
+registry::read_section::~read_section()
+{
+    if (--slot.depth == 0) { slot.epoch.store(0, std::memory_order_release); }
+}
+
+auto registry::find(const std::string& name) const -> entry*
+{
+    return read(
+        [&](const map_type& map) -> entry*
+        {
+            auto it = map.find(name);
+            return it != map.end() ? it->second.get() : nullptr;
+        });
+}
+
+auto registry::find_shared(const std::string& name) const -> std::shared_ptr<entry>
+{
+    return read(
+        [&](const map_type& map) -> std::shared_ptr<entry>
+        {
+            auto it = map.find(name);
+            return it != map.end() ? it->second : nullptr;
+        });
+}
+
+auto registry::size() const -> size_t
+{
+    return read([](const map_type& map) { return map.size(); });
+}
+
+auto registry::reader_slots() const -> size_t
+{
+    std::lock_guard<std::mutex> lock(slots_mutex);
+    return slots.size();
+}
+
+auto registry::insert(std::string name, entry hfp) -> entry*
+{
+    return insert_shared(std::move(name), std::move(hfp)).get();
+}
+
+auto registry::insert_shared(std::string name, entry hfp) -> std::shared_ptr<entry>
+{
+    auto ptr = std::make_shared<entry>(std::move(hfp));
+
+    std::lock_guard<std::mutex> lock(write_mutex);
+    // only the writers replace the current version, so it is read without the read section
+    const auto* map = current.load(std::memory_order_relaxed);
+    replace(map->insert(std::move(name), ptr));
+    return ptr;
+}
+
+auto registry::find_or_insert(const std::string& name, const entry& hfp) -> std::shared_ptr<entry>
+{
+    auto found = find_shared(name);
+    if (found) { return found; }
+
+    std::lock_guard<std::mutex> lock(write_mutex);
+    // checked again, another writer may have inserted the name meanwhile
+    const auto* map = current.load(std::memory_order_relaxed);
+    const auto it = map->find(name);
+    if (it != map->end()) { return it->second; }
+
+    auto ptr = std::make_shared<entry>(hfp);
+    replace(map->insert(name, ptr));
+    return ptr;
+}
+
+auto registry::update(std::vector<std::pair<std::string, entry>> entries, const std::vector<std::string>& removed,
+                      bool remove_others) -> size_t
+{
+    std::lock_guard<std::mutex> lock(write_mutex);
+    const auto* map = current.load(std::memory_order_relaxed);
+
+    size_t removed_count = 0;
+    auto updated = remove_others ? map_type() : *map;
+    if (!remove_others)
+    {
+        for (const auto& name : removed)
+            updated = updated.erase(name);
+        removed_count = map->size() - updated.size();
+    }
+
+    // the replaced entries are new objects, the old ones stay with the old version and with their shared owners
+    for (auto& hfp : entries)
+        updated = updated.insert(std::move(hfp.first), std::make_shared<entry>(std::move(hfp.second)));
+
+    if (remove_others)
+    {
+        for (const auto& old : *map)
+            removed_count += updated.find(old.first) == updated.end();
+    }
+
+    if (entries.empty() and removed_count == 0) { return 0; }
+
+    replace(std::move(updated));
+    return removed_count;
+}
+
+auto registry::publish(map_type map) -> void
+{
+    std::lock_guard<std::mutex> lock(write_mutex);
+    replace(std::move(map));
+}
+
+auto registry::replace(map_type map) -> void
+{
+    const auto* old = current.exchange(new map_type(std::move(map)));
+    // readers which announced this or an earlier epoch may still use the old version
+    retired.emplace_back(epoch.fetch_add(1), old);
+
+    reclaim();
+}
+
+auto registry::reclaim() -> void
+{
+    auto oldest_reader = std::numeric_limits<std::uint64_t>::max();
+    {
+        std::lock_guard<std::mutex> lock(slots_mutex);
+        for (const auto& slot : slots)
+        {
+            const auto reader_epoch = slot->epoch.load();
+            if (reader_epoch) { oldest_reader = std::min(oldest_reader, reader_epoch); }
+        }
+    }
+
+    auto unused = std::partition(retired.begin(), retired.end(),
+                                 [&](const std::pair<std::uint64_t, const map_type*>& old)
+                                 { return old.first >= oldest_reader; });
+    for (auto it = unused; it != retired.end(); ++it)
+        delete it->second;
+    retired.erase(unused, retired.end());
+}
+
+} // namespace hf::detail
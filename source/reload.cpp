@@ -0,0 +1,225 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty.hpp"
+
+#include "details.hpp"
+#include "watcher.hpp"
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/// Formulas compiled for the entry: the partial functions and the complete function.
+auto formulas_of(const hf::entry& hfp) -> std::vector<std::string>
+{
+    std::vector<std::string> bodies;
+    std::string complete;
+    for (auto i = 0; i < hfp.get_functions_count(); ++i)
+    {
+        bodies.emplace_back(hfp.get_function(i));
+        complete += (i ? "+" : "") + bodies.back();
+    }
+    bodies.push_back(std::move(complete));
+    return bodies;
+}
+} // namespace
+
+namespace hf
+{
+
+namespace detail
+{
+
+auto fitter_impl::load(const std::string& filename, bool incremental) -> bool
+{
+    trace_span span(&trace, incremental ? "reload" : "import", "io", filename);
+    tracer_activation trace_activation(&trace);
+    formula_cache_activation cache_activation(&formulas);
+
+    std::ifstream fparfile(filename.c_str());
+    if (!fparfile.is_open())
+    {
+        log.log(log_level::error, "No file {:s} to open.\n", filename);
+        return false;
+    }
+
+    incremental = incremental and filename == loaded_file;
+
+    // parsed aside, a parse error leaves the registry and the import state untouched
+    std::unordered_map<std::string, std::string> lines;
+    std::map<std::string, std::string> definitions; // the last definition of a name wins, as in the full import
+    std::map<std::string, entry> changed;           // entries of the changed definitions
+
+    auto parse = [&](const std::string& entry_line)
+    {
+        auto hfp = tools::parse_line_entry(entry_line, input_format_version);
+        definitions[hfp.first] = entry_line;
+        changed.erase(hfp.first);
+        changed.emplace(hfp.first, std::move(hfp.second));
+        return hfp.first;
+    };
+
+    std::string line;
+    while (std::getline(fparfile, line))
+    {
+        const auto known = incremental ? loaded_lines.find(line) : loaded_lines.end();
+        if (known != loaded_lines.end())
+        {
+            lines.emplace(line, known->second);
+            definitions[known->second] = line;
+            changed.erase(known->second);
+            continue;
+        }
+
+        lines.emplace(line, parse(line));
+    }
+    auto parsed = changed.size();
+
+    // unchanged line which did not define its entry before, e.g. a duplicate of the name was removed, or whose entry
+    // was removed by the program meanwhile
+    for (const auto& def : definitions)
+    {
+        if (changed.count(def.first)) { continue; }
+
+        const auto old = loaded_entries.find(def.first);
+        if (old == loaded_entries.end() or old->second.line != def.second or !hfpmap.find(def.first))
+        {
+            parse(def.second);
+            ++parsed;
+        }
+    }
+
+    std::unordered_map<std::string, loaded_entry> entries;
+    for (const auto& def : definitions)
+    {
+        const auto hfp = changed.find(def.first);
+        entries[def.first] = hfp != changed.end() ? loaded_entry{def.second, formulas_of(hfp->second)}
+                                                  : loaded_entries.at(def.first);
+    }
+
+    std::vector<std::string> removed;
+    if (incremental)
+    {
+        for (const auto& old : loaded_entries)
+        {
+            if (!definitions.count(old.first)) { removed.push_back(old.first); }
+        }
+    }
+
+    std::vector<std::pair<std::string, entry>> updates;
+    updates.reserve(changed.size());
+    for (auto& hfp : changed)
+        updates.emplace_back(hfp.first, std::move(hfp.second));
+
+    // changed entries are replaced by new ones, fits in progress keep the old ones
+    const auto removed_count = hfpmap.update(std::move(updates), removed, !incremental);
+
+    std::unordered_set<std::string> bodies;
+    for (const auto& loaded : entries)
+        bodies.insert(loaded.second.formulas.begin(), loaded.second.formulas.end());
+    formulas.retain(bodies);
+
+    loaded_file = filename;
+    loaded_lines = std::move(lines);
+    loaded_entries = std::move(entries);
+
+    log.log(log_level::info, "Imported {:s}: {:d} entries, {:d} parsed, {:d} removed.\n", filename, definitions.size(),
+            parsed, removed_count);
+
+    return true;
+}
+
+auto fitter_impl::reload() -> bool
+{
+    std::lock_guard<std::mutex> lock(load_mutex);
+
+    const auto selected = select_file();
+    if (selected.empty()) { return false; }
+
+    // written by this fitter, e.g. the watcher reacting to export_to_file(): the entries are up to date, and loading
+    // the file would reset their fit results
+    const auto exported = exported_files.find(selected);
+    if (exported != exported_files.end() and exported->second == stamp_of(selected))
+    {
+        log.log(log_level::info, "File {:s} was exported by this fitter and not changed since, skipped.\n", selected);
+        return true;
+    }
+
+    return load(selected, true);
+}
+
+} // namespace detail
+
+auto fitter::reload() -> bool { return m_d->reload(); }
+
+auto fitter::start_watch() -> bool
+{
+    if (m_d->watcher) { return true; }
+    if (!detail::file_watcher::supported)
+    {
+        m_d->log.log(log_level::error, "Watching files is not supported on this platform.\n");
+        return false;
+    }
+
+    std::vector<std::string> files;
+    {
+        std::lock_guard<std::mutex> lock(m_d->load_mutex);
+        files = {m_d->par_ref, m_d->par_aux};
+    }
+
+    // the implementation outlives the moves of the fitter, the watcher is stopped before it is destroyed
+    auto* impl = m_d.get();
+    auto on_change = [impl]()
+    {
+        try
+        {
+            impl->reload();
+        }
+        catch (const std::exception& e)
+        {
+            impl->log.log(log_level::error, "Reload failed, parameters kept: {:s}\n", e.what());
+        }
+    };
+
+    try
+    {
+        m_d->watcher = make_unique<detail::file_watcher>(files, std::move(on_change));
+    }
+    catch (const std::runtime_error& e)
+    {
+        m_d->log.log(log_level::error, "{:s}\n", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+auto fitter::stop_watch() -> void { m_d->watcher.reset(); }
+
+auto fitter::is_watching() const -> bool { return m_d->watcher != nullptr; }
+
+} // namespace hf
@@ -0,0 +1,163 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty.hpp"
+
+#include "details.hpp"
+#include "parallel.hpp"
+
+#include <TF1.h>
+#include <TGraph.h>
+#include <TH1.h>
+#include <TROOT.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hf
+{
+
+auto scan_result::make_graph() const -> std::unique_ptr<TGraph>
+{
+    // a failed or aborted unconstrained fit has no minimum, and a point may lie below a poor one
+    auto minimum = best_status == 0 ? best_objective : std::numeric_limits<Double_t>::infinity();
+    for (size_t i = 0; i < points.size(); ++i)
+        if (status[i] == 0) { minimum = std::min(minimum, objective[i]); }
+
+    auto graph = std::make_unique<TGraph>();
+    for (size_t i = 0, point = 0; i < points.size(); ++i)
+    {
+        if (status[i] != 0) { continue; }
+
+        graph->SetPoint(size_t2int(point), points[i], objective[i] - minimum);
+        ++point;
+    }
+
+    return graph;
+}
+
+auto fitter::scan(const entry& hfp, const TH1* hist, int par_id, Double_t from, Double_t to, int points,
+                  const char* pars, int threads) -> scan_result
+{
+    std::lock_guard<std::recursive_mutex> lock(hfp.m_d->lock.mutex);
+    const auto& model = *hfp.m_d;
+    const auto npar = model.complete_function_object.GetNpar();
+    if (par_id < 0 or par_id >= npar) { throw index_error("Parameter index out of range."); }
+
+    const auto nfree = std::count_if(model.pars.begin(), model.pars.begin() + npar,
+                                     [](const param& p) { return p.mode != param::fit_mode::fixed; });
+
+    points = std::max(points, 0);
+
+    scan_result result;
+    result.par_id = par_id;
+    result.points.resize(int2size_t(points));
+    result.objective.assign(int2size_t(points), 0.0);
+    result.status.assign(int2size_t(points), -1);
+    result.values.assign(int2size_t(npar), std::vector<Double_t>(int2size_t(points), 0.0));
+
+    for (auto i = 0; i < points; ++i)
+        result.points[int2size_t(i)] = points > 1 ? from + i * (to - from) / (points - 1) : from;
+
+    auto opts = model.minimizer;
+    if (detail::needs_fit_method_function(opts.algo)) { opts.algo = minimizer_opts::algorithm::standard; }
+    const auto limits = detail::merge_budget(model.budget, m_d->budget);
+    const auto stat = detail::statistic_from_option(pars);
+
+    detail::bin_data data;
+    detail::make_bin_data(hist, model.range_min, model.range_max, stat, data);
+    if (data.size() <= static_cast<size_t>(nfree)) { return result; }
+
+    auto start_pars = model.pars;
+    {
+        detail::trace_span span(&m_d->trace, "unconstrained", "fit", hist->GetName());
+
+        auto function = model.complete_function_object;
+        try
+        {
+            const auto res = detail::minimize(function, start_pars, data, stat, opts, limits);
+            result.best_status = res.status;
+            result.best_value = res.values[int2size_t(par_id)];
+            result.best_objective = res.fval;
+
+            if (res.status == 0)
+            {
+                for (size_t i = 0; i < int2size_t(npar); ++i)
+                    start_pars[i].value = res.values[i];
+            }
+        }
+        catch (const detail::budget_exceeded&)
+        {
+            // points start from the model parameters
+        }
+    }
+
+    // fixed in the same way as by param::fit_mode::fixed
+    start_pars[int2size_t(par_id)].mode = param::fit_mode::fixed;
+
+    if (points == 0) { return result; }
+
+    const auto chunks = detail::chunks_count(threads, points);
+    if (chunks > 1) { ROOT::EnableThreadSafety(); }
+
+    // TF1 evaluation is not thread-safe, every chunk gets own copy made here, in the calling thread
+    std::vector<TF1> functions(int2size_t(chunks), model.complete_function_object);
+
+    detail::run_chunks(
+        chunks,
+        [&](int chunk)
+        {
+            auto& function = functions[int2size_t(chunk)];
+            auto point_pars = start_pars;
+
+            const auto last = detail::chunk_begin(chunk + 1, chunks, points);
+            for (auto point = detail::chunk_begin(chunk, chunks, points); point < last; ++point)
+            {
+                const auto idx = int2size_t(point);
+                detail::trace_span span(&m_d->trace, "scan", "fit", std::to_string(result.points[idx]));
+
+                point_pars[int2size_t(par_id)].value = result.points[idx];
+                try
+                {
+                    const auto res = detail::minimize(function, point_pars, data, stat, opts, limits);
+                    for (size_t i = 0; i < int2size_t(npar); ++i)
+                        result.values[i][idx] = res.values[i];
+                    result.objective[idx] = res.fval;
+                    result.status[idx] = res.status;
+
+                    // warm start of the next point
+                    if (res.status != 0) { continue; }
+                    for (size_t i = 0; i < int2size_t(npar); ++i)
+                    {
+                        if (point_pars[i].mode != param::fit_mode::fixed) { point_pars[i].value = res.values[i]; }
+                    }
+                }
+                catch (const detail::budget_exceeded&)
+                {
+                    // point stays not fitted
+                }
+            }
+        });
+
+    return result;
+}
+
+} // namespace hf
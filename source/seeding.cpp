@@ -0,0 +1,226 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "details.hpp"
+#include "objective.hpp"
+
+#include <TF1.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+enum class component_type
+{
+    gaus,
+    expo
+};
+
+struct component
+{
+    component_type type;
+    int first_param;
+};
+
+/// Match term of form "name" or "name(N)", returns parameter offset or -1
+auto match_term(const std::string& term, const char* name) -> int
+{
+    const auto len = std::strlen(name);
+    if (term.compare(0, len, name) != 0) { return -1; }
+    if (term.size() == len) { return 0; }
+    if (term[len] != '(' or term.back() != ')' or term.size() < len + 3) { return -1; }
+
+    const auto index = term.substr(len + 1, term.size() - len - 2);
+    if (!std::all_of(index.begin(), index.end(), [](unsigned char c) { return std::isdigit(c); })) { return -1; }
+
+    return std::stoi(index);
+}
+
+/// Find gaus(N) and expo(N) terms in the functions bodies
+auto find_components(const std::vector<hf::detail::function_impl>& funcs) -> std::vector<component>
+{
+    std::vector<component> components;
+
+    for (const auto& func : funcs)
+    {
+        std::string body;
+        std::remove_copy_if(func.body_string.begin(), func.body_string.end(), std::back_inserter(body),
+                            [](unsigned char c) { return std::isspace(c); });
+
+        size_t pos = 0;
+        while (pos <= body.size())
+        {
+            const auto next = std::min(body.find('+', pos), body.size());
+            const auto term = body.substr(pos, next - pos);
+            pos = next + 1;
+
+            const auto gaus_idx = match_term(term, "gaus");
+            if (gaus_idx >= 0)
+            {
+                components.push_back({component_type::gaus, gaus_idx});
+                continue;
+            }
+
+            const auto expo_idx = match_term(term, "expo");
+            if (expo_idx >= 0) { components.push_back({component_type::expo, expo_idx}); }
+        }
+    }
+
+    return components;
+}
+
+/// Set parameter value unless it is fixed, respect limits
+auto seed_value(std::vector<Double_t>& values, const std::vector<hf::param>& pars, int index, Double_t value) -> bool
+{
+    const auto idx = int2size_t(index);
+    if (idx >= pars.size() or !std::isfinite(value)) { return false; }
+
+    const auto& par = pars[idx];
+    if (par.mode == hf::param::fit_mode::fixed) { return false; }
+    if (par.has_limits and par.min < par.max) { value = std::min(std::max(value, par.min), par.max); }
+
+    values[idx] = value;
+    return true;
+}
+
+} // namespace
+
+namespace hf::detail
+{
+
+auto seed_parameters(entry_impl& hfp, const bin_data& data) -> int
+{
+    const auto n = data.size();
+    if (n < 3) { return 0; }
+
+    const auto components = find_components(hfp.funcs);
+    if (components.empty()) { return 0; }
+
+    std::vector<Double_t> values(hfp.pars.size());
+    std::transform(hfp.pars.begin(), hfp.pars.end(), values.begin(), [](const hf::param& p) { return p.value; });
+
+    int seeded = 0;
+    std::vector<Double_t> residual = data.y;
+
+    // background: exponential through the averaged edges of the range
+    for (const auto& comp : components)
+    {
+        if (comp.type != component_type::expo) { continue; }
+
+        const auto edge = std::max<size_t>(n / 8, 1);
+        Double_t x_lo = 0, y_lo = 0, x_hi = 0, y_hi = 0;
+        for (size_t i = 0; i < edge; ++i)
+        {
+            x_lo += data.x[i];
+            y_lo += data.y[i];
+            x_hi += data.x[n - 1 - i];
+            y_hi += data.y[n - 1 - i];
+        }
+        x_lo /= edge;
+        y_lo /= edge;
+        x_hi /= edge;
+        y_hi /= edge;
+
+        if (y_lo <= 0 or y_hi <= 0 or x_hi <= x_lo) { continue; }
+
+        const auto slope = std::log(y_hi / y_lo) / (x_hi - x_lo);
+        const auto constant = std::log(y_lo) - slope * x_lo;
+
+        seeded += seed_value(values, hfp.pars, comp.first_param, constant);
+        seeded += seed_value(values, hfp.pars, comp.first_param + 1, slope);
+
+        for (size_t i = 0; i < n; ++i)
+            residual[i] -= std::exp(constant + slope * data.x[i]);
+
+        break; // only one background is estimated
+    }
+
+    // peaks: greedy search of the highest residual, width from the half maximum, centroid around the peak
+    for (const auto& comp : components)
+    {
+        if (comp.type != component_type::gaus) { continue; }
+
+        const auto max_it = std::max_element(residual.begin(), residual.end());
+        const auto height = *max_it;
+        if (height <= 0) { break; }
+
+        const auto peak = static_cast<size_t>(std::distance(residual.begin(), max_it));
+        auto left = peak;
+        auto right = peak;
+        while (left > 0 and residual[left - 1] > 0.5 * height)
+            --left;
+        while (right + 1 < n and residual[right + 1] > 0.5 * height)
+            ++right;
+
+        const auto bin_width = (data.x[n - 1] - data.x[0]) / static_cast<Double_t>(n - 1);
+        const auto fwhm = std::max(data.x[right] - data.x[left], bin_width);
+        const auto sigma = fwhm / 2.3548;
+
+        Double_t sum_w = 0, sum_wx = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (std::abs(data.x[i] - data.x[peak]) > 2 * sigma or residual[i] <= 0) { continue; }
+            sum_w += residual[i];
+            sum_wx += residual[i] * data.x[i];
+        }
+        const auto mean = sum_w > 0 ? sum_wx / sum_w : data.x[peak];
+
+        seeded += seed_value(values, hfp.pars, comp.first_param, height);
+        seeded += seed_value(values, hfp.pars, comp.first_param + 1, mean);
+        seeded += seed_value(values, hfp.pars, comp.first_param + 2, sigma);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto z = (data.x[i] - mean) / sigma;
+            residual[i] -= height * std::exp(-0.5 * z * z);
+        }
+    }
+
+    if (!seeded) { return 0; }
+
+    // accept the seeds only if they describe the data better than the current values
+    auto& function = hfp.complete_function_object;
+    const auto npar = std::min(int2size_t(function.GetNpar()), values.size());
+    for (size_t i = 0; i < npar; ++i)
+        function.SetParameter(size_t2int(i), hfp.pars[i].value);
+    const auto chi2_old = chisquare(function, data);
+
+    for (size_t i = 0; i < npar; ++i)
+        function.SetParameter(size_t2int(i), values[i]);
+    const auto chi2_new = chisquare(function, data);
+
+    if (!std::isfinite(chi2_new) or (std::isfinite(chi2_old) and chi2_new >= chi2_old))
+    {
+        for (size_t i = 0; i < npar; ++i)
+            function.SetParameter(size_t2int(i), hfp.pars[i].value);
+        return 0;
+    }
+
+    for (size_t i = 0; i < npar; ++i)
+        hfp.pars[i].value = values[i];
+
+    return seeded;
+}
+
+} // namespace hf::detail
@@ -0,0 +1,319 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty_service.hpp"
+
+#include "details.hpp"
+#include "service_protocol.hpp"
+
+#include <TF1.h>
+
+#include <fmt/core.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace hf::detail
+{
+
+struct service_impl
+{
+    explicit service_impl(fitter& fitter_ref) : hf_fitter(fitter_ref) {}
+
+    struct connection
+    {
+        int fd{-1};
+        std::string buffer; // received data, not handled yet
+        std::string output; // reply not sent yet, the next request waits for it
+    };
+
+    fitter& hf_fitter;
+    std::string path;
+    int listen_fd{-1};
+    int wake_pipe[2]{-1, -1};
+    std::vector<connection> connections;
+    std::atomic<size_t> requests{0};
+
+    auto close_all() -> void
+    {
+        for (auto& conn : connections)
+            ::close(conn.fd);
+        connections.clear();
+
+        if (listen_fd >= 0)
+        {
+            ::close(listen_fd);
+            ::unlink(path.c_str());
+            listen_fd = -1;
+        }
+        for (auto& fd : wake_pipe)
+        {
+            if (fd >= 0) { ::close(fd); }
+            fd = -1;
+        }
+    }
+
+    /// Parse and execute single request.
+    /// @return the reply line
+    auto handle(const std::string& line) -> std::string
+    {
+        ++requests;
+
+        std::istringstream tokens(line);
+        std::string command;
+        tokens >> command;
+
+        if (command == "PING") { return "OK\n"; }
+        if (command != "FIT") { return fmt::format("ERR unknown command '{}'\n", command); }
+
+        std::string name, options;
+        long long n = 0;
+        if (!(tokens >> name >> options >> n) or n <= 0) { return "ERR ill-formed request\n"; }
+
+        const auto bins = static_cast<size_t>(n);
+        std::vector<Double_t> numbers;
+        Double_t value = 0;
+        while (tokens >> value)
+            numbers.push_back(value);
+        if (!tokens.eof()) { return "ERR ill-formed number\n"; }
+
+        const auto with_errors = numbers.size() == 3 * bins + 1;
+        if (numbers.size() != 2 * bins + 1 and !with_errors)
+        {
+            return fmt::format("ERR expected {} or {} numbers, got {}\n", 2 * bins + 1, 3 * bins + 1, numbers.size());
+        }
+
+        const auto hfp = hf_fitter.find_fit_shared(name.c_str());
+        if (!hfp) { return fmt::format("ERR no entry '{}'\n", name); }
+
+        // the registered entry is never fitted, so its parameters stay the starting point of every request and the
+        // other users of the fitter do not see the results of the clients
+        entry copy = *hfp;
+        const auto* edges = numbers.data();
+        const auto* counts = edges + bins + 1;
+        const auto* errors = with_errors ? counts + bins : nullptr;
+        try
+        {
+            hf_fitter.fit_bins(&copy, name.c_str(), bins, edges, counts, errors, options.c_str());
+        }
+        catch (const std::exception& e)
+        {
+            return fmt::format("ERR {}\n", e.what());
+        }
+
+        const auto& result = copy.get_fit_result();
+        const auto& function = copy.get_function_object();
+        auto reply = fmt::format("OK {} {} {} {} {}", result.status, result.qa, service_format(result.chi2), result.ndf,
+                                 result.npar);
+        // the function of a rejected fit holds the errors of an earlier fit
+        const auto accepted = result.qa >= 0;
+        for (auto i = 0; i < result.npar; ++i)
+        {
+            reply += ' ' + service_format(copy.get_param(i).value);
+            reply += ' ' + service_format(accepted ? function.GetParError(i) : 0.0);
+        }
+        reply += '\n';
+        return reply;
+    }
+
+    /// Send as much of the pending reply as the socket accepts without blocking.
+    /// @return false if the connection failed
+    static auto flush(connection& conn) -> bool
+    {
+        while (!conn.output.empty())
+        {
+            const auto res = ::send(conn.fd, conn.output.data(), conn.output.size(), service_send_flags);
+            if (res < 0 and errno == EINTR) { continue; }
+            if (res < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) { return true; }
+            if (res <= 0) { return false; }
+            conn.output.erase(0, static_cast<size_t>(res));
+        }
+        return true;
+    }
+
+    /// Handle the complete requests of the connection while their replies are sent. A client which does not read its
+    /// replies is not served until it does, and it never blocks the other clients.
+    /// @return false if the connection should be closed
+    auto process(connection& conn) -> bool
+    {
+        std::string line;
+        while (conn.output.empty() and service_take_line(conn.buffer, line))
+        {
+            conn.output = handle(line);
+            if (!flush(conn)) { return false; }
+        }
+
+        if (conn.output.empty() and conn.buffer.size() > service_max_line)
+        {
+            conn.output = "ERR request too long\n";
+            flush(conn);
+            return false;
+        }
+        return true;
+    }
+
+    /// Receive the data of the connection and handle its requests.
+    /// @return false if the connection should be closed
+    auto serve(connection& conn) -> bool
+    {
+        char chunk[64 * 1024];
+        while (true)
+        {
+            const auto res = ::recv(conn.fd, chunk, sizeof(chunk), 0);
+            if (res < 0 and errno == EINTR) { continue; }
+            if (res < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) { break; }
+            if (res <= 0) { return false; }
+
+            conn.buffer.append(chunk, static_cast<size_t>(res));
+            break;
+        }
+        return process(conn);
+    }
+};
+
+} // namespace hf::detail
+
+namespace hf
+{
+
+service::service(fitter& hf_fitter) : m_d{std::make_unique<detail::service_impl>(hf_fitter)} {}
+
+service::~service() { m_d->close_all(); }
+
+auto service::listen(const std::string& socket_path) -> void
+{
+    m_d->close_all();
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() or socket_path.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error(fmt::format("Invalid socket path '{}'.", socket_path));
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    // replace the socket left by a previous run, but never other files
+    struct stat st;
+    if (::lstat(socket_path.c_str(), &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode)) { throw std::runtime_error(fmt::format("'{}' is not a socket.", socket_path)); }
+        ::unlink(socket_path.c_str());
+    }
+
+    const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { throw std::runtime_error(fmt::format("Could not create socket: {}", std::strerror(errno))); }
+    detail::service_configure(fd);
+
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 or ::listen(fd, 16) != 0)
+    {
+        const auto error = errno;
+        ::close(fd);
+        throw std::runtime_error(fmt::format("Could not listen on '{}': {}", socket_path, std::strerror(error)));
+    }
+
+    if (::pipe(m_d->wake_pipe) != 0)
+    {
+        const auto error = errno;
+        ::close(fd);
+        ::unlink(socket_path.c_str());
+        throw std::runtime_error(fmt::format("Could not create pipe: {}", std::strerror(error)));
+    }
+    for (const auto pipe_fd : m_d->wake_pipe)
+    {
+        ::fcntl(pipe_fd, F_SETFD, FD_CLOEXEC);
+        ::fcntl(pipe_fd, F_SETFL, O_NONBLOCK);
+    }
+
+    m_d->listen_fd = fd;
+    m_d->path = socket_path;
+}
+
+auto service::run() -> void
+{
+    if (m_d->listen_fd < 0) { throw std::logic_error("Service is not listening."); }
+
+    std::vector<pollfd> fds;
+    while (true)
+    {
+        fds.clear();
+        fds.push_back({m_d->wake_pipe[0], POLLIN, 0});
+        fds.push_back({m_d->listen_fd, POLLIN, 0});
+        // the connection with a pending reply waits until it can be written, its next requests are not read meanwhile
+        for (const auto& conn : m_d->connections)
+            fds.push_back({conn.fd, static_cast<short>(conn.output.empty() ? POLLIN : POLLOUT), 0});
+
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR) { continue; }
+            throw std::runtime_error(fmt::format("Service poll failed: {}", std::strerror(errno)));
+        }
+
+        if (fds[0].revents)
+        {
+            char drain[64];
+            while (::read(m_d->wake_pipe[0], drain, sizeof(drain)) > 0) {}
+            return;
+        }
+
+        // the connections accepted now are polled in the next round, fds refer only to the old ones
+        for (size_t i = fds.size() - 1; i >= 2; --i)
+        {
+            if (!fds[i].revents) { continue; }
+
+            auto& conn = m_d->connections[i - 2];
+            if (fds[i].revents & POLLIN and m_d->serve(conn)) { continue; }
+            if (fds[i].revents & POLLOUT and detail::service_impl::flush(conn) and m_d->process(conn)) { continue; }
+
+            ::close(conn.fd);
+            m_d->connections.erase(m_d->connections.begin() + static_cast<std::ptrdiff_t>(i - 2));
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+            const auto fd = ::accept(m_d->listen_fd, nullptr, nullptr);
+            if (fd >= 0)
+            {
+                detail::service_configure(fd);
+                ::fcntl(fd, F_SETFL, O_NONBLOCK);
+                m_d->connections.push_back({fd, {}, {}});
+            }
+        }
+    }
+}
+
+auto service::stop() -> void
+{
+    // write(2) is async-signal-safe, the pipe is non-blocking and a full pipe already wakes the service
+    const char byte = 0;
+    [[maybe_unused]] const auto res = ::write(m_d->wake_pipe[1], &byte, 1);
+}
+
+auto service::get_requests_count() const -> size_t { return m_d->requests; }
+
+} // namespace hf
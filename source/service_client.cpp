@@ -0,0 +1,136 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty_client.hpp"
+
+#include "service_protocol.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace hf
+{
+
+service_client::service_client(const std::string& socket_path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() or socket_path.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Invalid socket path '" + socket_path + "'.");
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { throw std::runtime_error(std::string("Could not create socket: ") + std::strerror(errno)); }
+    detail::service_configure(fd);
+
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        const auto error = errno;
+        ::close(fd);
+        throw std::runtime_error("Could not connect to '" + socket_path + "': " + std::strerror(error));
+    }
+}
+
+service_client::~service_client() { ::close(fd); }
+
+auto service_client::request(const std::string& line) -> std::string
+{
+    if (!detail::service_send(fd, line)) { throw std::runtime_error("Fit service connection broken."); }
+
+    std::string reply;
+    while (!detail::service_take_line(buffer, reply))
+    {
+        if (!detail::service_receive(fd, buffer)) { throw std::runtime_error("Fit service connection broken."); }
+    }
+    return reply;
+}
+
+auto service_client::ping() -> bool { return request("PING\n") == "OK"; }
+
+auto service_client::fit(const std::string& name, const std::vector<double>& edges, const std::vector<double>& counts,
+                         const std::vector<double>& errors, const std::string& options) -> service_reply
+{
+    if (counts.empty() or edges.size() != counts.size() + 1 or (!errors.empty() and errors.size() != counts.size()))
+    {
+        throw std::invalid_argument("Sizes of edges, counts and errors do not match.");
+    }
+
+    std::string line = "FIT " + name + ' ' + (options.empty() ? std::string("BQ") : options) + ' ' +
+                       std::to_string(counts.size());
+    line.reserve(line.size() + 25 * (edges.size() + counts.size() + errors.size()));
+    for (const auto* values : {&edges, &counts, &errors})
+    {
+        for (const auto value : *values)
+        {
+            line += ' ';
+            line += detail::service_format(value);
+        }
+    }
+    line += '\n';
+
+    const auto reply_line = request(line);
+    std::istringstream tokens(reply_line);
+    std::string head;
+    tokens >> head;
+
+    service_reply reply;
+    if (head != "OK")
+    {
+        std::getline(tokens >> std::ws, reply.error);
+        if (head != "ERR") { reply.error = "unexpected reply '" + reply_line + "'"; }
+        return reply;
+    }
+
+    int npar = 0;
+    tokens >> reply.status >> reply.qa >> reply.chi2 >> reply.ndf >> npar;
+    for (auto i = 0; i < npar; ++i)
+    {
+        double value = 0, error = 0;
+        tokens >> value >> error;
+        reply.values.push_back(value);
+        reply.errors.push_back(error);
+    }
+    if (!tokens)
+    {
+        reply.error = "ill-formed reply '" + reply_line + "'";
+        return reply;
+    }
+
+    reply.ok = true;
+    return reply;
+}
+
+auto service_client::fit(const std::string& name, double xmin, double xmax, const std::vector<double>& counts,
+                         const std::string& options) -> service_reply
+{
+    std::vector<double> edges(counts.size() + 1);
+    for (size_t i = 0; i < edges.size(); ++i)
+        edges[i] = xmin + (xmax - xmin) * static_cast<double>(i) / static_cast<double>(counts.size());
+
+    return fit(name, edges, counts, {}, options);
+}
+
+} // namespace hf
@@ -0,0 +1,148 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hellofitty.hpp"
+
+#include "details.hpp"
+#include "parallel.hpp"
+
+#include <TF1.h>
+#include <TGraphErrors.h>
+#include <TH2.h>
+#include <TROOT.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hf
+{
+
+auto slices_result::make_graph(int par_id) const -> std::unique_ptr<TGraphErrors>
+{
+    if (par_id < 0 or int2size_t(par_id) >= values.size()) { throw index_error("Parameter index out of range."); }
+
+    const auto& par_values = values[int2size_t(par_id)];
+    const auto& par_errors = errors[int2size_t(par_id)];
+
+    auto graph = std::make_unique<TGraphErrors>();
+    for (size_t i = 0, point = 0; i < centers.size(); ++i)
+    {
+        if (status[i] != 0) { continue; }
+
+        graph->SetPoint(size_t2int(point), centers[i], par_values[i]);
+        graph->SetPointError(size_t2int(point), 0.5 * widths[i], par_errors[i]);
+        ++point;
+    }
+
+    return graph;
+}
+
+auto fitter::fit_slices(TH2* hist, slice_axis axis, const entry& hfp, const char* pars, int threads) -> slices_result
+{
+    const auto along_x = axis == slice_axis::x;
+    const auto* sliced_axis = along_x ? hist->GetYaxis() : hist->GetXaxis();
+    const auto nslices = sliced_axis->GetNbins();
+
+    std::lock_guard<std::recursive_mutex> lock(hfp.m_d->lock.mutex);
+    const auto& model = *hfp.m_d;
+    const auto npar = model.complete_function_object.GetNpar();
+    const auto nfree = std::count_if(model.pars.begin(), model.pars.begin() + npar,
+                                     [](const param& p) { return p.mode != param::fit_mode::fixed; });
+
+    slices_result result;
+    result.centers.resize(int2size_t(nslices));
+    result.widths.resize(int2size_t(nslices));
+    result.status.assign(int2size_t(nslices), -1);
+    result.chi2.assign(int2size_t(nslices), 0.0);
+    result.ndf.assign(int2size_t(nslices), 0);
+    result.values.assign(int2size_t(npar), std::vector<Double_t>(int2size_t(nslices), 0.0));
+    result.errors.assign(int2size_t(npar), std::vector<Double_t>(int2size_t(nslices), 0.0));
+
+    for (auto slice = 1; slice <= nslices; ++slice)
+    {
+        result.centers[int2size_t(slice - 1)] = sliced_axis->GetBinCenter(slice);
+        result.widths[int2size_t(slice - 1)] = sliced_axis->GetBinWidth(slice);
+    }
+
+    if (nslices == 0 or npar == 0) { return result; }
+
+    auto opts = model.minimizer;
+    if (detail::needs_fit_method_function(opts.algo)) { opts.algo = minimizer_opts::algorithm::standard; }
+    const auto limits = detail::merge_budget(model.budget, m_d->budget);
+    const auto stat = detail::statistic_from_option(pars);
+
+    const auto chunks = detail::chunks_count(threads, nslices);
+    if (chunks > 1) { ROOT::EnableThreadSafety(); }
+
+    // TF1 evaluation is not thread-safe, every chunk gets own copy made here, in the calling thread
+    std::vector<TF1> functions(int2size_t(chunks), model.complete_function_object);
+
+    detail::run_chunks(
+        chunks,
+        [&](int chunk)
+        {
+            const auto first = 1 + detail::chunk_begin(chunk, chunks, nslices);
+            const auto last = detail::chunk_begin(chunk + 1, chunks, nslices);
+
+            auto& function = functions[int2size_t(chunk)];
+            auto start_pars = model.pars;
+            detail::bin_data data;
+
+            for (auto slice = first; slice <= last; ++slice)
+            {
+                detail::trace_span span(&m_d->trace, "slice", "fit", std::to_string(slice));
+
+                detail::make_slice_data(hist, slice, along_x, model.range_min, model.range_max, stat, data);
+                if (data.size() <= static_cast<size_t>(nfree)) { continue; }
+
+                const auto idx = int2size_t(slice - 1);
+                try
+                {
+                    const auto res = detail::minimize(function, start_pars, data, stat, opts, limits);
+
+                    for (size_t i = 0; i < int2size_t(npar); ++i)
+                    {
+                        result.values[i][idx] = res.values[i];
+                        result.errors[i][idx] = res.errors[i];
+                    }
+
+                    function.SetParameters(res.values.data());
+                    result.chi2[idx] = detail::chisquare(function, data);
+                    result.ndf[idx] = size_t2int(data.size()) - static_cast<int>(res.nfree);
+                    result.status[idx] = res.status;
+
+                    // warm start of the next slice
+                    if (res.status != 0) { continue; }
+                    for (size_t i = 0; i < int2size_t(npar); ++i)
+                    {
+                        if (start_pars[i].mode != param::fit_mode::fixed) { start_pars[i].value = res.values[i]; }
+                    }
+                }
+                catch (const detail::budget_exceeded&)
+                {
+                    // slice stays not fitted
+                }
+            }
+        });
+
+    return result;
+}
+
+} // namespace hf
@@ -0,0 +1,162 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "trace.hpp"
+
+#include <fmt/core.h>
+
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+std::atomic<std::uint64_t> next_tracer_id{1};
+std::atomic<std::uint32_t> next_thread_id{1};
+
+thread_local hf::detail::tracer* active_tracer{nullptr};
+
+/// Small sequential thread id, stable for the thread lifetime.
+auto thread_id() -> std::uint32_t
+{
+    thread_local const std::uint32_t tid = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+    return tid;
+}
+
+auto escape_json(const std::string& str) -> std::string
+{
+    std::string out;
+    out.reserve(str.size());
+    for (const auto c : str)
+    {
+        switch (c)
+        {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) { out += fmt::format("\\u{:04x}", c); }
+                else { out += c; }
+        }
+    }
+    return out;
+}
+} // namespace
+
+namespace hf::detail
+{
+
+tracer::tracer() : id(next_tracer_id.fetch_add(1, std::memory_order_relaxed)), origin(clock::now()) {}
+
+auto tracer::local_buffer() -> thread_buffer&
+{
+    // tracer ids are never reused, so a stale entry of a destroyed tracer is never hit
+    thread_local std::unordered_map<std::uint64_t, thread_buffer*> local_buffers;
+
+    auto it = local_buffers.find(id);
+    if (it != local_buffers.end()) { return *it->second; }
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    buffers.push_back(std::make_unique<thread_buffer>());
+    auto* buffer = buffers.back().get();
+    buffer->tid = thread_id();
+    local_buffers.emplace(id, buffer);
+
+    return *buffer;
+}
+
+auto tracer::complete(std::string name, const char* category, clock::time_point start, clock::time_point end,
+                      std::string arg) -> void
+{
+    if (!is_enabled()) { return; }
+
+    using us = std::chrono::duration<double, std::micro>;
+    local_buffer().events.push_back(
+        event{std::move(name), std::move(arg), category, us(start - origin).count(), us(end - start).count()});
+}
+
+auto tracer::size() const -> size_t
+{
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+
+    size_t n = 0;
+    for (const auto& buffer : buffers)
+        n += buffer->events.size();
+
+    return n;
+}
+
+auto tracer::clear() -> void
+{
+    // buffers are kept, threads hold pointers to them
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    for (auto& buffer : buffers)
+        buffer->events.clear();
+}
+
+auto tracer::write(const std::string& filename) const -> bool
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        fmt::print(stderr, "Can't create trace file {:s}.\n", filename);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const auto& buffer : buffers)
+    {
+        file << fmt::format("{:s}\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{:d},"
+                            "\"args\":{{\"name\":\"thread {:d}\"}}}}",
+                            first ? "" : ",", buffer->tid, buffer->tid);
+        first = false;
+
+        for (const auto& ev : buffer->events)
+        {
+            file << fmt::format(",\n{{\"name\":\"{:s}\",\"cat\":\"{:s}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},"
+                                "\"pid\":1,\"tid\":{:d}",
+                                escape_json(ev.name), ev.category, ev.ts, ev.dur, buffer->tid);
+            if (!ev.arg.empty()) { file << fmt::format(",\"args\":{{\"name\":\"{:s}\"}}", escape_json(ev.arg)); }
+            file << '}';
+        }
+    }
+
+    file << "\n]}\n";
+
+    return file.good();
+}
+
+auto current_tracer() -> tracer* { return active_tracer; }
+
+tracer_activation::tracer_activation(tracer* trc) : previous(active_tracer) { active_tracer = trc; }
+
+tracer_activation::~tracer_activation() { active_tracer = previous; }
+
+} // namespace hf::detail
@@ -0,0 +1,155 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "watcher.hpp"
+
+#include <stdexcept>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#endif
+
+namespace
+{
+#ifdef __linux__
+/// Quiet period closing a burst of events, e.g. truncate and write of a single save.
+constexpr int settle_ms = 50;
+#endif
+} // namespace
+
+namespace hf::detail
+{
+
+#ifdef __linux__
+
+const bool file_watcher::supported = true;
+
+file_watcher::file_watcher(const std::vector<std::string>& files, std::function<void()> callback)
+    : notify(std::move(callback))
+{
+    events_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (events_fd < 0) { throw std::runtime_error(std::string("inotify_init1: ") + std::strerror(errno)); }
+
+    if (::pipe(stop_fds) != 0)
+    {
+        const auto error = errno;
+        ::close(events_fd);
+        throw std::runtime_error(std::string("pipe: ") + std::strerror(error));
+    }
+    for (auto fd : stop_fds)
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    for (const auto& file : files)
+    {
+        if (file.empty()) { continue; }
+
+        const auto path = std::filesystem::path(file);
+        const auto dir = path.has_parent_path() ? path.parent_path().string() : std::string(".");
+        const auto wd =
+            ::inotify_add_watch(events_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+        if (wd < 0)
+        {
+            const auto error = errno;
+            ::close(events_fd);
+            ::close(stop_fds[0]);
+            ::close(stop_fds[1]);
+            throw std::runtime_error("Cannot watch " + dir + ": " + std::strerror(error));
+        }
+        names.emplace_back(wd, path.filename().string());
+    }
+
+    worker = std::thread(&file_watcher::run, this);
+}
+
+file_watcher::~file_watcher()
+{
+    const char byte = 0;
+    while (::write(stop_fds[1], &byte, 1) < 0 and errno == EINTR) {}
+    worker.join();
+
+    ::close(events_fd);
+    ::close(stop_fds[0]);
+    ::close(stop_fds[1]);
+}
+
+auto file_watcher::run() -> void
+{
+    alignas(inotify_event) char buffer[4096];
+    auto pending = false;
+
+    while (true)
+    {
+        pollfd fds[2] = {{events_fd, POLLIN, 0}, {stop_fds[0], POLLIN, 0}};
+        const auto res = ::poll(fds, 2, pending ? settle_ms : -1);
+        if (res < 0)
+        {
+            if (errno == EINTR) { continue; }
+            return;
+        }
+        if (fds[1].revents) { return; }
+
+        if (res == 0)
+        {
+            pending = false;
+            notify();
+            continue;
+        }
+
+        while (true)
+        {
+            const auto len = ::read(events_fd, buffer, sizeof(buffer));
+            if (len <= 0) { break; }
+
+            for (auto pos = 0L; pos < len;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + pos);
+                pos += static_cast<long>(sizeof(inotify_event) + event->len);
+                if (!event->len) { continue; }
+
+                for (const auto& name : names)
+                {
+                    if (name.first == event->wd and name.second == event->name) { pending = true; }
+                }
+            }
+        }
+    }
+}
+
+#else
+
+const bool file_watcher::supported = false;
+
+file_watcher::file_watcher(const std::vector<std::string>& /*files*/, std::function<void()> /*callback*/)
+{
+    throw std::runtime_error("Watching files is not supported on this platform.");
+}
+
+file_watcher::~file_watcher() = default;
+
+auto file_watcher::run() -> void {}
+
+#endif
+
+} // namespace hf::detail
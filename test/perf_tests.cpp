@@ -0,0 +1,304 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_config.h"
+
+#include <TH1.h>
+#include <TRandom3.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// Timed tests of a fixed synthetic workload, compared against the baseline file. Environment:
+///   HF_PERF_BASELINE  - baseline file, metric per line: "name seconds"
+///   HF_PERF_TOLERANCE - allowed relative slowdown, default 0.2
+///   HF_PERF_SCALING   - allowed growth of the time per item with ten times more items, default 2
+///   HF_PERF_UPDATE    - if set, measured values are written to the baseline file instead of being checked
+/// Metrics missing in the baseline are reported and not checked. The scaling of each workload with its size and the
+/// counts of the fitted and registered entries do not depend on the machine and are always checked.
+
+namespace
+{
+
+constexpr int repetitions = 3;
+
+auto env_or(const char* name, const char* fallback) -> std::string
+{
+    const auto* value = std::getenv(name);
+    return value ? value : fallback;
+}
+
+class baseline_env : public ::testing::Environment
+{
+public:
+    auto SetUp() -> void override
+    {
+        filename = env_or("HF_PERF_BASELINE", (tests_src_path + "perf_baseline.txt").c_str());
+        tolerance = std::stod(env_or("HF_PERF_TOLERANCE", "0.2"));
+        scaling = std::stod(env_or("HF_PERF_SCALING", "2"));
+        update = std::getenv("HF_PERF_UPDATE") != nullptr;
+
+        std::ifstream file(filename);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() or line[0] == '#') { continue; }
+
+            std::istringstream iss(line);
+            std::string name;
+            double value = 0;
+            if (iss >> name >> value) { baseline[name] = value; }
+        }
+    }
+
+    auto TearDown() -> void override
+    {
+        if (!update) { return; }
+
+        std::ofstream file(filename);
+        file << "# HelloFitty performance baseline, best of " << repetitions << " runs in seconds\n";
+        for (const auto& metric : baseline)
+            file << fmt::format("{:s} {:.6f}\n", metric.first, metric.second);
+    }
+
+    /// Check or record the metric.
+    auto check(const std::string& name, double seconds) -> void
+    {
+        fmt::print("[ PERF     ] {:s}: {:.6f} s\n", name, seconds);
+
+        if (update)
+        {
+            baseline[name] = seconds;
+            return;
+        }
+
+        const auto it = baseline.find(name);
+        if (it == baseline.end())
+        {
+            fmt::print("[ PERF     ] {:s}: no baseline in {:s}\n", name, filename);
+            return;
+        }
+
+        EXPECT_LE(seconds, it->second * (1.0 + tolerance))
+            << name << " regressed: " << seconds << " s vs baseline " << it->second << " s, tolerance "
+            << tolerance * 100 << "%";
+    }
+
+    /// Check that the time per item does not grow with the workload size, e.g. a linear import stays linear.
+    auto check_scaling(const std::string& name, double small_seconds, int small_items, double large_seconds,
+                       int large_items) -> void
+    {
+        const auto growth = (large_seconds / large_items) / (small_seconds / small_items);
+        fmt::print("[ PERF     ] {:s}: time per item x{:.2f} from {:d} to {:d} items\n", name, growth, small_items,
+                   large_items);
+
+        EXPECT_LE(growth, scaling) << name << " scales worse than linearly: time per item x" << growth << " from "
+                                   << small_items << " to " << large_items << " items";
+    }
+
+private:
+    std::string filename;
+    double tolerance{0.2};
+    double scaling{2.0};
+    bool update{false};
+    std::map<std::string, double> baseline;
+};
+
+auto* const env = dynamic_cast<baseline_env*>(::testing::AddGlobalTestEnvironment(new baseline_env));
+
+/// Best time of the repeated runs, setup is not timed.
+auto best_of(const std::function<void()>& setup, const std::function<void()>& run) -> double
+{
+    auto best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repetitions; ++i)
+    {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+auto write_parameters(const std::string& filename, int lines) -> void
+{
+    std::ofstream file(filename);
+    for (int i = 0; i < lines; ++i)
+        file << fmt::format(" hist_{:d}\t0 10 0 gaus(0) expo(3) | {:d} 5 0.5 1 -0.5\n", i, 1000 + i % 100);
+}
+
+auto make_histograms(int count, const char* prefix) -> std::vector<std::unique_ptr<TH1D>>
+{
+    TRandom3 rng(4357);
+
+    std::vector<std::unique_ptr<TH1D>> hists;
+    hists.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i)
+    {
+        auto hist = std::make_unique<TH1D>(fmt::format("{:s}_{:d}", prefix, i).c_str(), "", 50, 0, 10);
+        hist->SetDirectory(nullptr);
+        for (int bin = 1; bin <= 50; ++bin)
+        {
+            const auto x = hist->GetBinCenter(bin);
+            const auto content = rng.Poisson(1000 * std::exp(-0.5 * (x - 5) * (x - 5) / 0.25) + std::exp(5 - 0.5 * x));
+            hist->SetBinContent(bin, content);
+            hist->SetBinError(bin, std::sqrt(content));
+        }
+        hists.push_back(std::move(hist));
+    }
+    return hists;
+}
+
+auto quiet_fitter(hf::fitter& fitter) -> void
+{
+    fitter.set_verbose(false);
+    fitter.set_log_level(hf::log_level::error);
+}
+
+auto time_import(const std::string& input) -> double
+{
+    std::unique_ptr<hf::fitter> fitter;
+    return best_of(
+        [&]
+        {
+            fitter = std::make_unique<hf::fitter>();
+            quiet_fitter(*fitter);
+        },
+        [&] { ASSERT_TRUE(fitter->init_from_file(input)); });
+}
+
+auto time_export(const std::string& input, const std::string& output) -> double
+{
+    hf::fitter fitter;
+    quiet_fitter(fitter);
+    EXPECT_TRUE(fitter.init_from_file(input, output, hf::fitter::priority_mode::reference));
+
+    return best_of([] {}, [&] { ASSERT_TRUE(fitter.export_to_file()); });
+}
+
+} // namespace
+
+TEST(PerfTests, Import100k)
+{
+    const auto input = tests_bin_path + "perf_import.txt";
+    write_parameters(input, 10000);
+    const auto small = time_import(input);
+    write_parameters(input, 100000);
+    const auto elapsed = time_import(input);
+
+    env->check("import_100k", elapsed);
+    env->check_scaling("import", small, 10000, elapsed, 100000);
+    std::remove(input.c_str());
+}
+
+TEST(PerfTests, Export100k)
+{
+    const auto input = tests_bin_path + "perf_export_in.txt";
+    const auto output = tests_bin_path + "perf_export_out.txt";
+    write_parameters(input, 10000);
+    const auto small = time_export(input, output);
+    write_parameters(input, 100000);
+    const auto elapsed = time_export(input, output);
+
+    env->check("export_100k", elapsed);
+    env->check_scaling("export", small, 10000, elapsed, 100000);
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+
+TEST(PerfTests, Fit1k)
+{
+    const auto input = tests_bin_path + "perf_fit.txt";
+    write_parameters(input, 1000);
+
+    std::vector<std::unique_ptr<TH1D>> hists;
+    hf::fitter fitter;
+    quiet_fitter(fitter);
+
+    int fitted = 0;
+    const auto elapsed = best_of(
+        [&]
+        {
+            hists = make_histograms(1000, "hist");
+            ASSERT_TRUE(fitter.init_from_file(input));
+            fitted = 0;
+        },
+        [&]
+        {
+            for (auto& hist : hists)
+                fitted += fitter.fit(hist.get()).first;
+        });
+
+    env->check("fit_1k", elapsed);
+    // a faster run which does not fit is not an improvement
+    EXPECT_EQ(fitted, 1000);
+    std::remove(input.c_str());
+}
+
+TEST(PerfTests, GenericFallback10k)
+{
+    std::vector<std::unique_ptr<TH1D>> hists;
+    hf::fitter fitter;
+    quiet_fitter(fitter);
+
+    const auto generic = hf::tools::parse_line_entry(" generic\t0 10 0 gaus(0) expo(3) | 1000 5 0.5 1 -0.5");
+
+    int fitted = 0;
+    const auto elapsed = best_of(
+        [&]
+        {
+            hists = make_histograms(10000, "fallback");
+            fitter.clear();
+            fitter.set_generic_entry(generic.second);
+            fitted = 0;
+        },
+        [&]
+        {
+            for (auto& hist : hists)
+                fitted += fitter.fit(hist.get()).first;
+        });
+
+    env->check("generic_10k", elapsed);
+    EXPECT_EQ(fitted, 10000);
+    for (auto& hist : hists)
+        ASSERT_NE(fitter.find_fit(hist.get()), nullptr);
+}
+
+TEST(PerfTests, GenericFallbackScaling)
+{
+    // registration of the fallback entries alone, which the fits hide in GenericFallback10k
+    const auto generic = hf::tools::parse_line_entry(" generic\t0 10 0 gaus(0) expo(3) | 1000 5 0.5 1 -0.5");
+
+    auto time_fallbacks = [&](int count)
+    {
+        std::vector<std::string> names;
+        for (int i = 0; i < count; ++i)
+            names.push_back(fmt::format("fallback_{:d}", i));
+
+        hf::fitter fitter;
+        quiet_fitter(fitter);
+        fitter.set_generic_entry(generic.second);
+
+        return best_of([&] { fitter.clear(); },
+                       [&]
+                       {
+                           for (const auto& name : names)
+                               fitter.find_or_make(name.c_str());
+                       });
+    };
+
+    env->check_scaling("generic_fallback", time_fallbacks(2000), 2000, time_fallbacks(20000), 20000);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include <TH1.h>
+
+#include <cmath>
+#include <memory>
+
+namespace
+{
+auto make_gaus_hist(const char* name) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name, "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(1000. * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+
+auto make_gaus_entry() -> hf::entry
+{
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+    return hfp;
+}
+} // namespace
+
+TEST(TestsBootstrap, Distributions)
+{
+    auto hist = make_gaus_hist("h_bootstrap");
+    const auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    const auto result = fitter.bootstrap(hfp, hist.get(), 200, 42, "BQ", 4);
+
+    ASSERT_EQ(result.nominal_status, 0);
+    ASSERT_NEAR(result.nominal[1], 5.0, 0.01);
+    ASSERT_EQ(result.toys(), 200u);
+    ASSERT_GT(result.good_toys(), 190u);
+
+    // model entry is not modified
+    ASSERT_EQ(hfp.param(1).value, 4.8);
+
+    // the spread of the mean matches the expected statistical error sigma/sqrt(N)
+    const auto expected = 0.5 / std::sqrt(1000. * std::sqrt(2 * std::acos(-1.)) * 0.5 / 0.1);
+    ASSERT_NEAR(result.std_dev(1), expected, 0.3 * expected);
+    ASSERT_NEAR(result.mean(1), 5.0, 3 * expected);
+    ASSERT_LT(result.quantile(1, 0.16), result.quantile(1, 0.5));
+    ASSERT_LT(result.quantile(1, 0.5), result.quantile(1, 0.84));
+    ASSERT_LE(result.quantile(1, -1), result.quantile(1, 0));
+
+    ASSERT_THROW(result.mean(3), hf::index_error);
+    ASSERT_THROW(result.quantile(-1, 0.5), hf::index_error);
+}
+
+TEST(TestsBootstrap, ReproducibleAcrossThreads)
+{
+    auto hist = make_gaus_hist("h_bootstrap_repro");
+    const auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    const auto serial = fitter.bootstrap(hfp, hist.get(), 20, 7, "BQ", 1);
+    const auto parallel = fitter.bootstrap(hfp, hist.get(), 20, 7, "BQ", 3);
+    const auto other_seed = fitter.bootstrap(hfp, hist.get(), 20, 8, "BQ", 1);
+
+    ASSERT_EQ(serial.status, parallel.status);
+    ASSERT_EQ(serial.values, parallel.values);
+    ASSERT_NE(serial.values, other_seed.values);
+}
+
+TEST(TestsBootstrap, NoToys)
+{
+    auto hist = make_gaus_hist("h_bootstrap_none");
+
+    hf::fitter fitter;
+    const auto result = fitter.bootstrap(make_gaus_entry(), hist.get(), 0, 1);
+    ASSERT_EQ(result.nominal_status, 0);
+    ASSERT_EQ(result.toys(), 0u);
+    ASSERT_EQ(result.good_toys(), 0u);
+    ASSERT_EQ(result.mean(1), 0.0);
+    ASSERT_EQ(result.std_dev(1), 0.0);
+}
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_config.h"
+
+#include <TH1.h>
+#include <TList.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace
+{
+auto make_hist(const char* name, double mean) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name, "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= hist->GetNbinsX(); ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(1000. * std::exp(-0.5 * (x - mean) * (x - mean) / 0.25));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+
+auto make_fitter() -> hf::fitter
+{
+    hf::entry hfp(1, 9);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 500);
+    hfp.set_param(1, 5.0);
+    hfp.set_param(2, 1.0);
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_generic_entry(hfp);
+    return fitter;
+}
+
+auto count_lines(const std::string& filename) -> int
+{
+    std::ifstream file(filename);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const auto content = buffer.str();
+    return static_cast<int>(std::count(content.begin(), content.end(), '\n'));
+}
+} // namespace
+
+TEST(TestsCheckpoint, Resume)
+{
+    const auto filename = tests_bin_path + "checkpoint_resume.ckpt";
+    std::remove(filename.c_str());
+
+    {
+        auto fitter = make_fitter();
+        fitter.set_checkpoint(filename);
+        ASSERT_EQ(fitter.resume(), 0u);
+
+        auto h1 = make_hist("h_ckpt_1", 4.5);
+        auto h2 = make_hist("h_ckpt_2", 5.5);
+        ASSERT_TRUE(fitter.fit(h1.get()).first);
+        ASSERT_TRUE(fitter.fit(h2.get()).first);
+        ASSERT_EQ(count_lines(filename), 2);
+    }
+
+    // the run killed while writing the third record
+    std::ofstream(filename, std::ios::app) << "+ h_ckpt_3\t1 9 0 gaus(0) | 1";
+
+    auto fitter = make_fitter();
+    fitter.set_checkpoint(filename);
+    ASSERT_EQ(fitter.resume(), 2u);
+    ASSERT_TRUE(fitter.is_completed("h_ckpt_1"));
+    ASSERT_TRUE(fitter.is_completed("h_ckpt_2"));
+    ASSERT_FALSE(fitter.is_completed("h_ckpt_3"));
+    ASSERT_NEAR(fitter.find_fit("h_ckpt_2")->param(1).value, 5.5, 0.01);
+
+    // completed fits are skipped, the histogram is not touched
+    auto h1 = make_hist("h_ckpt_1", 4.5);
+    const auto res = fitter.fit(h1.get());
+    ASSERT_TRUE(res.first);
+    ASSERT_NEAR(res.second->param(1).value, 4.5, 0.01);
+    ASSERT_EQ(h1->GetListOfFunctions()->At(0), nullptr);
+
+    auto h3 = make_hist("h_ckpt_3", 5.0);
+    ASSERT_TRUE(fitter.fit(h3.get()).first);
+    ASSERT_NE(h3->GetListOfFunctions()->At(0), nullptr);
+    ASSERT_EQ(count_lines(filename), 3);
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestsCheckpoint, RetryFailed)
+{
+    const auto filename = tests_bin_path + "checkpoint_failed.ckpt";
+    std::remove(filename.c_str());
+
+    {
+        auto fitter = make_fitter();
+        fitter.set_checkpoint(filename);
+
+        auto h1 = make_hist("h_ckpt_ok", 4.5);
+        auto h2 = std::make_unique<TH1D>("h_ckpt_failed", "", 100, 0, 10); // empty, the fit fails
+        h2->SetDirectory(nullptr);
+        ASSERT_TRUE(fitter.fit(h1.get()).first);
+        ASSERT_FALSE(fitter.fit(h2.get()).first);
+        ASSERT_EQ(count_lines(filename), 2);
+    }
+
+    // the failed fit is retried by default
+    {
+        auto fitter = make_fitter();
+        fitter.set_checkpoint(filename);
+        ASSERT_EQ(fitter.resume(), 1u);
+        ASSERT_TRUE(fitter.is_completed("h_ckpt_ok"));
+        ASSERT_FALSE(fitter.is_completed("h_ckpt_failed"));
+
+        auto h2 = make_hist("h_ckpt_failed", 5.5);
+        ASSERT_TRUE(fitter.fit(h2.get()).first);
+        ASSERT_NE(h2->GetListOfFunctions()->At(0), nullptr);
+    }
+
+    // the retried fit is recorded as completed
+    {
+        auto fitter = make_fitter();
+        fitter.set_checkpoint(filename);
+        ASSERT_EQ(fitter.resume(), 2u);
+        ASSERT_TRUE(fitter.is_completed("h_ckpt_failed"));
+    }
+
+    // the failed fits are skipped on request
+    std::ofstream(filename, std::ios::app) << "- h_ckpt_lost\t1 9 0 gaus(0) | 500 5 1\n";
+    {
+        auto fitter = make_fitter();
+        fitter.set_checkpoint(filename);
+        ASSERT_EQ(fitter.resume(true), 3u);
+        ASSERT_TRUE(fitter.is_completed("h_ckpt_lost"));
+
+        auto h3 = make_hist("h_ckpt_lost", 5.0);
+        ASSERT_FALSE(fitter.fit(h3.get()).first);
+        ASSERT_EQ(h3->GetListOfFunctions()->At(0), nullptr);
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestsCheckpoint, Interval)
+{
+    const auto filename = tests_bin_path + "checkpoint_interval.ckpt";
+    std::remove(filename.c_str());
+
+    auto fitter = make_fitter();
+    fitter.set_checkpoint(filename, 3);
+
+    auto h1 = make_hist("h_ckpt_a", 4.5);
+    auto h2 = make_hist("h_ckpt_b", 5.5);
+    fitter.fit(h1.get());
+    fitter.fit(h2.get());
+    ASSERT_EQ(count_lines(filename), 0);
+
+    fitter.flush_checkpoint();
+    ASSERT_EQ(count_lines(filename), 2);
+
+    // refits of the current run are recorded again, the resume keeps the last record
+    fitter.fit(h1.get());
+    fitter.flush_checkpoint();
+    ASSERT_EQ(count_lines(filename), 3);
+    ASSERT_EQ(fitter.resume(), 2u);
+    ASSERT_EQ(count_lines(filename), 2);
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestsCheckpoint, FailedCompaction)
+{
+    const auto filename = tests_bin_path + "checkpoint_compaction.ckpt";
+    std::remove(filename.c_str());
+
+    auto fitter = make_fitter();
+    fitter.set_checkpoint(filename);
+
+    auto h1 = make_hist("h_ckpt_c1", 4.5);
+    ASSERT_TRUE(fitter.fit(h1.get()).first);
+
+    // the compacted copy cannot be created, the journal is still written
+    std::filesystem::create_directory(filename + ".tmp");
+    ASSERT_THROW(fitter.resume(), std::runtime_error);
+    std::filesystem::remove(filename + ".tmp");
+
+    auto h2 = make_hist("h_ckpt_c2", 5.5);
+    ASSERT_TRUE(fitter.fit(h2.get()).first);
+    ASSERT_EQ(count_lines(filename), 2);
+
+    std::remove(filename.c_str());
+}
+
+#ifdef __linux__
+TEST(TestsCheckpoint, WriteError)
+{
+    // writes to /dev/full fail as on a full disk
+    auto fitter = make_fitter();
+    fitter.set_checkpoint("/dev/full");
+
+    auto h1 = make_hist("h_ckpt_full", 4.5);
+    ASSERT_THROW(fitter.fit(h1.get()), std::runtime_error);
+    ASSERT_THROW(fitter.flush_checkpoint(), std::runtime_error);
+}
+#endif
+
+TEST(TestsCheckpoint, NextToAuxiliaryFile)
+{
+    hf::fitter fitter;
+    ASSERT_THROW(fitter.set_checkpoint(), std::logic_error);
+    ASSERT_THROW(fitter.resume(), std::logic_error);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include <TH1.h>
+#include <TList.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+auto make_gaus_hist(const std::string& name, double amplitude, double mean, double sigma) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name.c_str(), "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(amplitude * std::exp(-0.5 * (x - mean) * (x - mean) / (sigma * sigma)));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+
+auto make_gaus_entry(double amplitude, double mean, double sigma) -> std::unique_ptr<hf::entry>
+{
+    auto hfp = std::make_unique<hf::entry>(0, 10);
+    hfp->add_function("gaus(0)");
+    hfp->set_param(0, amplitude);
+    hfp->set_param(1, mean);
+    hfp->set_param(2, sigma);
+    return hfp;
+}
+
+struct sectors
+{
+    std::vector<std::unique_ptr<TH1D>> hists;
+    std::vector<std::unique_ptr<hf::entry>> entries;
+
+    explicit sectors(const char* prefix)
+    {
+        const double means[] = {3.0, 5.0, 7.0};
+        const double amplitudes[] = {1000, 500, 2000};
+        const double starts[] = {0.7, 0.4, 0.6};
+        for (int i = 0; i < 3; ++i)
+        {
+            hists.push_back(make_gaus_hist(prefix + std::to_string(i), amplitudes[i], means[i], 0.5));
+            entries.push_back(make_gaus_entry(0.8 * amplitudes[i], means[i] - 0.2, starts[i]));
+        }
+    }
+
+    auto entry_ptrs() -> std::vector<hf::entry*> { return {entries[0].get(), entries[1].get(), entries[2].get()}; }
+    auto hist_ptrs() -> std::vector<TH1*> { return {hists[0].get(), hists[1].get(), hists[2].get()}; }
+};
+} // namespace
+
+TEST(TestsCombined, SharedWidth)
+{
+    sectors data("h_combined_");
+    const std::vector<hf::param_link> links{{0, 2, 1, 2}, {1, 2, 2, 2}};
+
+    hf::fitter fitter;
+    ASSERT_TRUE(fitter.fit_combined(data.entry_ptrs(), data.hist_ptrs(), links, "BQ", 3));
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const auto& hfp = *data.entries[i];
+        ASSERT_NEAR(hfp.param(2).value, 0.5, 0.01);
+        ASSERT_EQ(hfp.param(2).value, data.entries[0]->param(2).value);
+        ASSERT_NEAR(hfp.param(1).value, 3.0 + 2.0 * i, 0.01);
+
+        const auto& result = hfp.get_fit_result();
+        ASSERT_TRUE(result.is_valid());
+        ASSERT_EQ(result.npar, 3);
+        ASSERT_GT(result.ndf, 0);
+        ASSERT_TRUE(result.has_covariance());
+        ASSERT_GT(result.get_covariance(2, 2), 0);
+
+        ASSERT_NE(data.hists[i]->GetListOfFunctions()->At(0), nullptr);
+    }
+
+    // the shared parameter has the same variance in all entries
+    ASSERT_DOUBLE_EQ(data.entries[0]->get_fit_result().get_covariance(2, 2),
+                     data.entries[2]->get_fit_result().get_covariance(2, 2));
+}
+
+TEST(TestsCombined, ThreadsIndependent)
+{
+    sectors serial("h_combined_serial_");
+    sectors parallel("h_combined_parallel_");
+    const std::vector<hf::param_link> links{{0, 2, 1, 2}, {0, 2, 2, 2}};
+
+    hf::fitter fitter;
+    ASSERT_TRUE(fitter.fit_combined(serial.entry_ptrs(), serial.hist_ptrs(), links, "BQ", 1));
+    ASSERT_TRUE(fitter.fit_combined(parallel.entry_ptrs(), parallel.hist_ptrs(), links, "BQ", 2));
+
+    for (size_t i = 0; i < 3; ++i)
+        for (int p = 0; p < 3; ++p)
+            ASSERT_DOUBLE_EQ(serial.entries[i]->param(p).value, parallel.entries[i]->param(p).value);
+}
+
+TEST(TestsCombined, Arguments)
+{
+    sectors data("h_combined_args_");
+
+    hf::fitter fitter;
+    ASSERT_THROW(fitter.fit_combined(data.entry_ptrs(), {data.hists[0].get()}, {}), std::logic_error);
+    ASSERT_THROW(fitter.fit_combined(data.entry_ptrs(), data.hist_ptrs(), {{0, 2, 3, 2}}), hf::index_error);
+    ASSERT_THROW(fitter.fit_combined(data.entry_ptrs(), data.hist_ptrs(), {{0, 3, 1, 2}}), hf::index_error);
+    ASSERT_FALSE(fitter.fit_combined({}, {}, {}));
+
+    // nothing is fitted when the arguments are rejected
+    ASSERT_EQ(data.entries[0]->param(2).value, 0.7);
+}
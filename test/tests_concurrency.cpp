@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include <TH1.h>
+#include <TROOT.h>
+
+#include <fmt/core.h>
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+auto make_gaus_hist(const std::string& name, double mean) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name.c_str(), "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(1000. * std::exp(-0.5 * (x - mean) * (x - mean) / 0.25));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+} // namespace
+
+TEST(TestsConcurrency, VerbosityPerInstance)
+{
+    hf::fitter quiet;
+    hf::fitter loud;
+    ASSERT_TRUE(quiet.get_verbose());
+
+    quiet.set_verbose(false);
+    ASSERT_FALSE(quiet.get_verbose());
+    ASSERT_TRUE(loud.get_verbose());
+}
+
+TEST(TestsConcurrency, IndependentFitters)
+{
+    ROOT::EnableThreadSafety();
+
+    constexpr int threads = 4;
+    constexpr int fits = 10;
+
+    std::vector<int> good(threads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(
+            [t, &good]
+            {
+                // settings differ between the threads, none of them may leak to the other fitters
+                hf::fitter fitter;
+                fitter.set_verbose(t % 2 == 0);
+                fitter.set_log_level(hf::log_level::error);
+                fitter.set_fit_engine(t % 2 ? hf::fitter::fit_engine::native : hf::fitter::fit_engine::root);
+                fitter.set_fit_stats(true);
+                fitter.set_trace(t % 2 == 1);
+
+                const auto mean = 4.0 + 0.5 * t;
+                for (int i = 0; i < fits; ++i)
+                {
+                    auto hist = make_gaus_hist(fmt::format("h_concurrent_{:d}_{:d}", t, i), mean);
+
+                    hf::entry hfp(1, 9);
+                    hfp.add_function("gaus(0)");
+                    hfp.set_param(0, 800);
+                    hfp.set_param(1, mean - 0.2);
+                    hfp.set_param(2, 0.7);
+                    if (t == 2) { hfp.set_minimizer(hf::minimizer_opts{hf::minimizer_opts::algorithm::migrad}); }
+
+                    if (fitter.fit(&hfp, hist.get()) and std::abs(hfp.param(1).value - mean) < 0.01) { ++good[t]; }
+                }
+
+                if (fitter.get_fit_stats().size() != fits) { good[t] = -1; }
+            });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    for (int t = 0; t < threads; ++t)
+        ASSERT_EQ(good[t], fits) << "thread " << t;
+}
@@ -183,3 +183,35 @@ TEST(TestsEntry, Backups)
 
     hfp1.drop();
 }
+
+TEST(TestsEntry, MemoryUsage)
+{
+    hf::entry hfp(0, 10);
+    const auto empty = hfp.get_memory_usage();
+    ASSERT_GT(empty.overhead, 0u);
+    ASSERT_EQ(empty.total(), empty.functions + empty.formulas + empty.parameters + empty.styles + empty.overhead);
+
+    hfp.add_function("gaus(0)");
+    const auto one = hfp.get_memory_usage();
+    ASSERT_GT(one.functions, empty.functions);
+
+    hfp.add_function("expo(3) + [5]*x*x*x*x*x*x*x*x*x*x*x*x*x*x*x*x*x");
+    const auto two = hfp.get_memory_usage();
+    ASSERT_GT(two.functions, one.functions);
+    ASSERT_GT(two.formulas, one.formulas);
+    ASSERT_GE(two.parameters, 6 * sizeof(hf::param));
+
+    hfp.set_function_style(0).set_line_color(2);
+    ASSERT_GT(hfp.get_memory_usage().styles, two.styles);
+
+    hf::fitter fitter;
+    const auto none = fitter.get_memory_usage();
+    ASSERT_EQ(none.total(), 0u);
+
+    fitter.insert_parameter("h1", hfp);
+    fitter.insert_parameter("h2", hfp);
+
+    const auto registry = fitter.get_memory_usage();
+    ASSERT_EQ(registry.functions, 2 * hfp.get_memory_usage().functions);
+    ASSERT_GT(registry.overhead, 2 * hfp.get_memory_usage().overhead);
+}
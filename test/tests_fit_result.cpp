@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_config.h"
+
+#include <TF1.h>
+#include <TH1.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace
+{
+auto make_gaus_hist(const char* name) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name, "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(1000. * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+
+auto make_gaus_entry() -> hf::entry
+{
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+    return hfp;
+}
+
+auto check_result(const hf::entry& hfp) -> void
+{
+    const auto& res = hfp.get_fit_result();
+    ASSERT_TRUE(res.is_valid());
+    ASSERT_EQ(res.npar, 3);
+    ASSERT_GT(res.ncalls, 0u);
+    ASSERT_GT(res.ndf, 0);
+    ASSERT_GT(res.chi2, 0);
+    ASSERT_TRUE(res.has_covariance());
+    ASSERT_EQ(res.covariance.size(), 6u);
+
+    const auto mean_error = hfp.get_function_object().GetParError(1);
+    ASSERT_NEAR(std::sqrt(res.get_covariance(1, 1)), mean_error, 0.01 * mean_error);
+    ASSERT_EQ(res.get_covariance(0, 2), res.get_covariance(2, 0));
+}
+} // namespace
+
+TEST(TestsFitResult, NotFitted)
+{
+    const auto hfp = make_gaus_entry();
+    const auto& res = hfp.get_fit_result();
+    ASSERT_EQ(res.status, -1);
+    ASSERT_FALSE(res.is_valid());
+    ASSERT_FALSE(res.has_covariance());
+    ASSERT_THROW(res.get_covariance(0, 0), hf::index_error);
+}
+
+TEST(TestsFitResult, NativeEngine)
+{
+    auto hist = make_gaus_hist("h_result_native");
+    auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+    check_result(hfp);
+    ASSERT_THROW(hfp.get_fit_result().get_covariance(3, 0), hf::index_error);
+}
+
+TEST(TestsFitResult, RootEngine)
+{
+    auto hist = make_gaus_hist("h_result_root");
+    auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+    check_result(hfp);
+}
+
+TEST(TestsFitResult, RootEngineNullOptions)
+{
+    auto hist = make_gaus_hist("h_result_null_options");
+    auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get(), nullptr));
+    check_result(hfp);
+}
+
+TEST(TestsFitResult, AbortedFitDropsCovariance)
+{
+    auto hist = make_gaus_hist("h_result_aborted");
+    auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_fit_budget(hf::fit_budget{5, 0});
+    ASSERT_FALSE(fitter.fit(&hfp, hist.get()));
+
+    const auto& res = hfp.get_fit_result();
+    ASSERT_LT(res.qa, 0);
+    ASSERT_FALSE(res.is_valid());
+    ASSERT_FALSE(res.has_covariance());
+}
+
+TEST(TestsFitResult, ExportResults)
+{
+    auto hist = make_gaus_hist("h_result_export");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    auto* hfp = fitter.insert_parameter("h_result_export", make_gaus_entry());
+    fitter.insert_parameter("h_result_unfitted", make_gaus_entry());
+    ASSERT_TRUE(fitter.fit(hfp, hist.get()));
+
+    const auto filename = tests_bin_path + "fit_results.csv";
+    ASSERT_TRUE(fitter.export_results(filename));
+
+    std::ifstream file(filename);
+    std::string header, fitted, unfitted;
+    std::getline(file, header);
+    std::getline(file, fitted);
+    std::getline(file, unfitted);
+    ASSERT_EQ(header, "name,status,qa,edm,ncalls,chi2,ndf,npar,covariance");
+    ASSERT_EQ(fitted.rfind("\"h_result_export\",0,", 0), 0u);
+    ASSERT_EQ(unfitted, "\"h_result_unfitted\",-1,-1,0,0,0,0,0,");
+    std::remove(filename.c_str());
+}
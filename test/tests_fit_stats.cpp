@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_config.h"
+
+#include <TH1.h>
+
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace
+{
+auto make_record(std::string name, double minimize) -> hf::fit_record
+{
+    hf::fit_record rec;
+    rec.name = std::move(name);
+    rec.time[static_cast<size_t>(hf::fit_record::phase::prepare)] = 0.001;
+    rec.time[static_cast<size_t>(hf::fit_record::phase::minimize)] = minimize;
+    return rec;
+}
+} // namespace
+
+TEST(TestsFitStats, Aggregation)
+{
+    hf::fit_stats stats;
+    ASSERT_EQ(stats.percentile(50), 0.0);
+    ASSERT_TRUE(stats.slowest(3).empty());
+
+    for (int i = 1; i <= 10; ++i)
+        stats.add(make_record("h" + std::to_string(i), 0.1 * i));
+
+    ASSERT_EQ(stats.size(), 10u);
+    ASSERT_NEAR(stats.total(hf::fit_record::phase::prepare), 0.01, 1e-12);
+    ASSERT_NEAR(stats.total(hf::fit_record::phase::minimize), 5.5, 1e-12);
+    ASSERT_NEAR(stats.total(), 5.51, 1e-12);
+
+    ASSERT_NEAR(stats.percentile(hf::fit_record::phase::minimize, 50), 0.5, 1e-12);
+    ASSERT_NEAR(stats.percentile(hf::fit_record::phase::minimize, 90), 0.9, 1e-12);
+    ASSERT_NEAR(stats.percentile(hf::fit_record::phase::minimize, 100), 1.0, 1e-12);
+    ASSERT_NEAR(stats.percentile(hf::fit_record::phase::minimize, 0), 0.1, 1e-12);
+
+    const auto slow = stats.slowest(3);
+    ASSERT_EQ(slow.size(), 3u);
+    ASSERT_EQ(slow[0].name, "h10");
+    ASSERT_EQ(slow[1].name, "h9");
+    ASSERT_EQ(slow[2].name, "h8");
+
+    stats.clear();
+    ASSERT_EQ(stats.size(), 0u);
+}
+
+TEST(TestsFitStats, ExportCsv)
+{
+    hf::fit_stats stats;
+    stats.add(make_record("h1", 0.5));
+
+    const auto filename = tests_bin_path + "fit_stats.csv";
+    ASSERT_TRUE(stats.export_csv(filename));
+
+    std::ifstream file(filename);
+    std::string header, line;
+    std::getline(file, header);
+    std::getline(file, line);
+
+    ASSERT_EQ(header,
+              "name,prepare,chi2_pre,minimize,clone,chi2_post,qa,chi2_final,propagate,attach,total,ncalls,status,qa");
+    ASSERT_EQ(line.substr(0, 5), "\"h1\",");
+}
+
+TEST(TestsFitStats, FitterRecords)
+{
+    auto hist = std::make_unique<TH1D>("h_stats", "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        hist->SetBinContent(i, std::round(1000. * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25)));
+        hist->SetBinError(i, std::sqrt(hist->GetBinContent(i)));
+    }
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+    ASSERT_EQ(fitter.get_fit_stats().size(), 0u);
+
+    fitter.set_fit_stats(true);
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+
+    const auto& stats = fitter.get_fit_stats();
+    ASSERT_EQ(stats.size(), 2u);
+
+    const auto& rec = stats.get_records().front();
+    ASSERT_EQ(rec.name, "h_stats");
+    ASSERT_EQ(rec.status, 0);
+    ASSERT_GT(rec.ncalls, 0u);
+    ASSERT_GT(rec.get(hf::fit_record::phase::minimize), 0.0);
+    ASSERT_GT(rec.total(), 0.0);
+
+    fitter.clear_fit_stats();
+    ASSERT_EQ(fitter.get_fit_stats().size(), 0u);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include "logger.hpp"
+
+#include <fmt/core.h>
+
+namespace
+{
+struct counted
+{
+    int* count;
+};
+} // namespace
+
+template <> struct fmt::formatter<counted> : fmt::formatter<int>
+{
+    auto format(const counted& c, format_context& ctx) const -> format_context::iterator
+    {
+        return fmt::formatter<int>::format(++*c.count, ctx);
+    }
+};
+
+TEST(TestsLogger, Levels)
+{
+    hf::detail::logger log;
+    ASSERT_EQ(log.get_level(), hf::log_level::info);
+    ASSERT_FALSE(log.is_async());
+    ASSERT_FALSE(log.enabled(hf::log_level::debug));
+    ASSERT_TRUE(log.enabled(hf::log_level::info));
+    ASSERT_TRUE(log.enabled(hf::log_level::error));
+
+    log.set_level(hf::log_level::off);
+    ASSERT_FALSE(log.enabled(hf::log_level::error));
+    ASSERT_FALSE(log.enabled(hf::log_level::off));
+}
+
+TEST(TestsLogger, FormatOnlyEnabled)
+{
+    int count = 0;
+
+    hf::detail::logger log;
+    log.set_level(hf::log_level::warning);
+    log.log(hf::log_level::info, "not formatted {}\n", counted{&count});
+    ASSERT_EQ(count, 0);
+
+    log.log(hf::log_level::warning, "formatted {}\n", counted{&count});
+    ASSERT_EQ(count, 1);
+
+    log.set_async(true);
+    log.log(hf::log_level::error, fmt::fg(fmt::color::crimson), "formatted {}", counted{&count});
+    ASSERT_EQ(count, 2);
+
+    hf::fitter::flush_log();
+}
+
+TEST(TestsLogger, FitterConfiguration)
+{
+    hf::fitter fitter1;
+    hf::fitter fitter2;
+
+    fitter1.set_log_level(hf::log_level::error);
+    ASSERT_EQ(fitter1.get_log_level(), hf::log_level::error);
+    ASSERT_EQ(fitter2.get_log_level(), hf::log_level::info);
+}
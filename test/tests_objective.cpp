@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include "details.hpp"
+#include "objective.hpp"
+
+#include <TF1.h>
+#include <TGraph.h>
+#include <TH1.h>
+#include <TList.h>
+
+#include <cmath>
+#include <memory>
+
+namespace
+{
+auto make_gaus_hist(const char* name) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name, "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(1000. * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+} // namespace
+
+TEST(TestsObjective, StatisticFromOption)
+{
+    ASSERT_EQ(hf::detail::statistic_from_option("BQ"), hf::detail::fit_statistic::chi2);
+    ASSERT_EQ(hf::detail::statistic_from_option("LBQ"), hf::detail::fit_statistic::likelihood);
+    ASSERT_EQ(hf::detail::statistic_from_option("q l"), hf::detail::fit_statistic::likelihood);
+    ASSERT_EQ(hf::detail::statistic_from_option(nullptr), hf::detail::fit_statistic::chi2);
+}
+
+TEST(TestsObjective, HistogramSnapshot)
+{
+    auto hist = make_gaus_hist("h_snapshot");
+
+    hf::detail::bin_data data;
+    hf::detail::make_bin_data(hist.get(), 0, 10, hf::detail::fit_statistic::chi2, data);
+    const auto non_empty = data.size();
+    ASSERT_GT(non_empty, 0u);
+    ASSERT_LT(non_empty, 100u);
+
+    hf::detail::make_bin_data(hist.get(), 0, 10, hf::detail::fit_statistic::likelihood, data);
+    ASSERT_EQ(data.size(), 100u);
+
+    // the bin 6.0--6.1 starts at the range end, but its center is out of range
+    hf::detail::make_bin_data(hist.get(), 4, 6, hf::detail::fit_statistic::likelihood, data);
+    ASSERT_EQ(data.size(), 20u);
+    ASSERT_NEAR(data.x.front(), 4.05, 1e-9);
+    ASSERT_NEAR(data.x.back(), 5.95, 1e-9);
+
+    hf::detail::make_bin_data(hist.get(), 4.07, 5.93, hf::detail::fit_statistic::likelihood, data);
+    ASSERT_EQ(data.size(), 18u);
+    ASSERT_NEAR(data.x.front(), 4.15, 1e-9);
+    ASSERT_NEAR(data.x.back(), 5.85, 1e-9);
+}
+
+TEST(TestsObjective, GraphSnapshot)
+{
+    const double x[] = {1, 2, 3, 4};
+    const double y[] = {2, 4, 6, 8};
+    TGraph graph(4, x, y);
+
+    hf::detail::bin_data data;
+    hf::detail::make_bin_data(&graph, 1.5, 4, hf::detail::fit_statistic::chi2, data);
+    ASSERT_EQ(data.size(), 3u);
+    ASSERT_EQ(data.ey[0], 1.0);
+
+    TF1 line("line", "[0]*x", 0, 5, TF1::EAddToList::kNo);
+    line.SetParameter(0, 2);
+    ASSERT_DOUBLE_EQ(hf::detail::chisquare(line, data), 0.0);
+}
+
+TEST(TestsObjective, NativeFit)
+{
+    auto hist = make_gaus_hist("h_native");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    ASSERT_EQ(fitter.get_fit_engine(), hf::fitter::fit_engine::native);
+
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+
+    ASSERT_NEAR(hfp.param(0).value, 1000, 10);
+    ASSERT_NEAR(hfp.param(1).value, 5.0, 0.01);
+    ASSERT_NEAR(hfp.param(2).value, 0.5, 0.01);
+
+    auto* fitted = dynamic_cast<TF1*>(hist->GetListOfFunctions()->At(0));
+    ASSERT_NE(fitted, nullptr);
+    ASSERT_NEAR(fitted->GetParameter(1), 5.0, 0.01);
+}
+
+TEST(TestsObjective, NativeFitMinimizerOptions)
+{
+    auto hist = make_gaus_hist("h_native_opts");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+    hfp.set_minimizer(hf::minimizer_opts{hf::minimizer_opts::algorithm::migrad, 2, 0.001, 10000});
+
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+    ASSERT_NEAR(hfp.param(1).value, 5.0, 0.01);
+}
+
+TEST(TestsObjective, NativeFitBudget)
+{
+    auto hist = make_gaus_hist("h_native_budget");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_fit_budget(hf::fit_budget{5, 0});
+
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+
+    ASSERT_FALSE(fitter.fit(&hfp, hist.get()));
+    ASSERT_TRUE(hfp.get_flag_budget_exceeded());
+    ASSERT_EQ(hfp.param(0).value, 800);
+    ASSERT_EQ(hfp.param(1).value, 4.8);
+    ASSERT_EQ(hfp.param(2).value, 0.7);
+
+    // entry budget takes precedence over the global one
+    hfp.set_fit_budget(hf::fit_budget{100000, 0});
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+    ASSERT_FALSE(hfp.get_flag_budget_exceeded());
+    ASSERT_NEAR(hfp.param(1).value, 5.0, 0.01);
+}
+
+TEST(TestsObjective, EnginesFitSameBins)
+{
+    // no empty bins, so the bins at the range edges count
+    auto hist = make_gaus_hist("h_engines_bins");
+    for (int i = 1; i <= hist->GetNbinsX(); ++i)
+    {
+        hist->SetBinContent(i, hist->GetBinContent(i) + 10);
+        hist->SetBinError(i, std::sqrt(hist->GetBinContent(i)));
+    }
+
+    auto make_entry = []()
+    {
+        // the edge bins 2.0--2.1 and 7.9--8.0 have their centers out of range
+        hf::entry hfp(2.07, 7.93);
+        hfp.add_function("gaus(0)");
+        hfp.add_function("pol0(3)");
+        hfp.set_param(0, 900);
+        hfp.set_param(1, 4.9);
+        hfp.set_param(2, 0.6);
+        hfp.set_param(3, 8);
+        return hfp;
+    };
+
+    hf::fitter root_fitter;
+    auto root_hfp = make_entry();
+    ASSERT_TRUE(root_fitter.fit(&root_hfp, hist.get()));
+
+    hf::fitter native_fitter;
+    native_fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    auto native_hfp = make_entry();
+    ASSERT_TRUE(native_fitter.fit(&native_hfp, hist.get()));
+
+    ASSERT_EQ(root_hfp.get_fit_result().ndf, 58 - 4);
+    ASSERT_EQ(native_hfp.get_fit_result().ndf, root_hfp.get_fit_result().ndf);
+    ASSERT_NEAR(native_hfp.get_fit_result().chi2, root_hfp.get_fit_result().chi2,
+                1e-3 * root_hfp.get_fit_result().chi2);
+}
+
+TEST(TestsObjective, RootEngineBudget)
+{
+    auto hist = make_gaus_hist("h_root_budget");
+
+    hf::fitter fitter;
+    ASSERT_EQ(fitter.get_fit_engine(), hf::fitter::fit_engine::root);
+    fitter.set_fit_budget(hf::fit_budget{0, 1e-9});
+
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+
+    // the time is checked during the fit, the first call exceeds it
+    ASSERT_FALSE(fitter.fit(&hfp, hist.get()));
+    ASSERT_TRUE(hfp.get_flag_budget_exceeded());
+    ASSERT_EQ(hfp.param(1).value, 4.8);
+
+    hfp.set_fit_budget(hf::fit_budget{5, 0});
+    ASSERT_FALSE(fitter.fit(&hfp, hist.get()));
+    ASSERT_TRUE(hfp.get_flag_budget_exceeded());
+    ASSERT_EQ(hfp.param(1).value, 4.8);
+
+    hfp.set_fit_budget(hf::fit_budget{100000, 60});
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+    ASSERT_FALSE(hfp.get_flag_budget_exceeded());
+    ASSERT_NEAR(hfp.param(1).value, 5.0, 0.01);
+    ASSERT_NE(hist->GetListOfFunctions()->At(0), nullptr);
+}
+
+TEST(TestsObjective, GroupedSnapshot)
+{
+    auto hist = make_gaus_hist("h_grouped");
+
+    hf::detail::bin_data data;
+    hf::detail::make_bin_data(hist.get(), 4, 6, hf::detail::fit_statistic::likelihood, data, 8);
+    ASSERT_EQ(data.size(), 3u);
+    ASSERT_NEAR(data.x[0], 4.4, 1e-9);
+    ASSERT_NEAR(data.x[2], 5.8, 1e-9);
+
+    double sum = 0;
+    for (int bin = 41; bin <= 48; ++bin)
+        sum += hist->GetBinContent(bin);
+    ASSERT_NEAR(data.y[0], sum / 8, 1e-9);
+}
+
+TEST(TestsObjective, CoarseToFine)
+{
+    auto hist = make_gaus_hist("h_coarse");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_coarse_to_fine(8);
+    ASSERT_EQ(fitter.get_coarse_to_fine(), 8);
+
+    hf::entry hfp(1, 9);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 500);
+    hfp.set_param(1, 4.0);
+    hfp.set_param(2, 1.0);
+
+    ASSERT_TRUE(fitter.fit(&hfp, hist.get()));
+    ASSERT_NEAR(hfp.param(0).value, 1000, 10);
+    ASSERT_NEAR(hfp.param(1).value, 5.0, 0.01);
+    ASSERT_NEAR(hfp.param(2).value, 0.5, 0.01);
+    ASSERT_EQ(hist->GetNbinsX(), 100);
+}
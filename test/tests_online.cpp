@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include <TH1.h>
+#include <TList.h>
+
+#include <cmath>
+#include <memory>
+
+namespace
+{
+auto fill_gaus(TH1* hist, double amplitude) -> void
+{
+    hist->Reset();
+    double sum = 0;
+    for (int i = 1; i <= hist->GetNbinsX(); ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(amplitude * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+        sum += content;
+    }
+    hist->SetEntries(sum);
+}
+
+auto make_hist(const char* name) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name, "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    return hist;
+}
+
+auto make_generic_entry() -> hf::entry
+{
+    hf::entry hfp(1, 9);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 500);
+    hfp.set_param(1, 4.0);
+    hfp.set_param(2, 1.0);
+    return hfp;
+}
+} // namespace
+
+TEST(TestsOnline, RefitThreshold)
+{
+    auto hist = make_hist("h_online");
+    fill_gaus(hist.get(), 1000);
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_generic_entry(make_generic_entry());
+    fitter.set_refit_threshold(0.05);
+    ASSERT_EQ(fitter.get_refit_threshold(), 0.05);
+
+    auto res = fitter.fit_online(hist.get());
+    ASSERT_EQ(res.first, hf::fitter::refit_status::fitted);
+    ASSERT_NEAR(res.second->param(0).value, 1000, 10);
+
+    // unchanged and slightly grown histograms are not refitted
+    ASSERT_EQ(fitter.fit_online(hist.get()).first, hf::fitter::refit_status::skipped);
+    fill_gaus(hist.get(), 1020);
+    ASSERT_EQ(fitter.fit_online(hist.get()).first, hf::fitter::refit_status::skipped);
+    ASSERT_NEAR(res.second->param(0).value, 1000, 10);
+
+    // the change is counted from the last fit, not from the last call
+    fill_gaus(hist.get(), 1060);
+    res = fitter.fit_online(hist.get());
+    ASSERT_EQ(res.first, hf::fitter::refit_status::fitted);
+    ASSERT_NEAR(res.second->param(0).value, 1060, 10);
+    ASSERT_TRUE(res.second->get_fit_result().is_valid());
+
+    // reset of the histogram
+    fill_gaus(hist.get(), 1040);
+    ASSERT_EQ(fitter.fit_online(hist.get()).first, hf::fitter::refit_status::fitted);
+}
+
+TEST(TestsOnline, RetryAfterFailure)
+{
+    auto hist = make_hist("h_online_empty");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_generic_entry(make_generic_entry());
+    fitter.set_refit_threshold(0.5);
+
+    auto res = fitter.fit_online(hist.get());
+    ASSERT_EQ(res.first, hf::fitter::refit_status::failed);
+    ASSERT_EQ(res.second->param(1).value, 4.0);
+    ASSERT_EQ(fitter.fit_online(hist.get()).first, hf::fitter::refit_status::skipped);
+
+    // any change triggers the fit after a failure
+    fill_gaus(hist.get(), 1000);
+    res = fitter.fit_online(hist.get());
+    ASSERT_EQ(res.first, hf::fitter::refit_status::fitted);
+    ASSERT_NEAR(res.second->param(1).value, 5.0, 0.01);
+}
+
+TEST(TestsOnline, RebinKeepsHistogram)
+{
+    auto hist = make_hist("h_online_rebin");
+    fill_gaus(hist.get(), 1000);
+
+    auto generic = make_generic_entry();
+    generic.set_flag_rebin(2);
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_generic_entry(generic);
+    fitter.set_refit_threshold(0.05);
+
+    // merged pairs of bins hold twice the content
+    auto res = fitter.fit_online(hist.get());
+    ASSERT_EQ(res.first, hf::fitter::refit_status::fitted);
+    ASSERT_NEAR(res.second->param(0).value, 2000, 40);
+    ASSERT_EQ(hist->GetNbinsX(), 100);
+    ASSERT_NE(hist->GetListOfFunctions()->At(0), nullptr);
+
+    fill_gaus(hist.get(), 1100);
+    res = fitter.fit_online(hist.get());
+    ASSERT_EQ(res.first, hf::fitter::refit_status::fitted);
+    ASSERT_NEAR(res.second->param(0).value, 2200, 40);
+    ASSERT_NEAR(res.second->param(2).value, 0.5, 0.05);
+    ASSERT_EQ(hist->GetNbinsX(), 100);
+
+    // a range without entries is not fitted, the function of the accepted fit stays with the live histogram
+    const auto* drawn = hist->GetListOfFunctions()->At(0);
+    ASSERT_NE(drawn, nullptr);
+    for (int i = 0; i <= hist->GetNbinsX() + 1; ++i)
+    {
+        hist->SetBinContent(i, 0);
+        hist->SetBinError(i, 0);
+    }
+    hist->SetEntries(0);
+    ASSERT_EQ(fitter.fit_online(hist.get()).first, hf::fitter::refit_status::failed);
+    ASSERT_EQ(hist->GetListOfFunctions()->At(0), drawn);
+}
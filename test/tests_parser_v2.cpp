@@ -91,3 +91,67 @@ TEST(TestsParserV2, ComplexLine)
 
     hfp.second.print("hist_1");
 }
+
+TEST(TestsParserV2, MinimizerOptions)
+{
+    auto hfp = hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1  2 : 1 3  3 | minimizer=fumili2 strategy=2",
+                                           hf::format_version::v2);
+
+    ASSERT_EQ(hfp.second.get_function_params_count(), 3);
+    ASSERT_EQ(hfp.second.param(1).min, 1);
+    ASSERT_EQ(hfp.second.param(1).max, 3);
+
+    const auto& opts = hfp.second.get_minimizer();
+    ASSERT_EQ(opts.algo, hf::minimizer_opts::algorithm::fumili2);
+    ASSERT_EQ(opts.strategy, 2);
+    ASSERT_EQ(opts.tolerance, 0);
+    ASSERT_EQ(opts.max_calls, 0);
+
+    auto out = hf::tools::format_line_entry(hfp.first, &hfp.second, hf::format_version::v2);
+    ASSERT_STREQ(out.c_str(), " hist_1\t1 10 0 gaus(0) |  1  2 : 1 3  3 | minimizer=fumili2 strategy=2");
+
+    hfp.second.set_minimizer(hf::minimizer_opts{hf::minimizer_opts::algorithm::gsl_lm, -1, 0.01, 500});
+    out = hf::tools::format_line_entry(hfp.first, &hfp.second, hf::format_version::v2);
+    ASSERT_STREQ(out.c_str(), " hist_1\t1 10 0 gaus(0) |  1  2 : 1 3  3 | minimizer=gsl_lm tolerance=0.01 calls=500");
+
+    auto hfp2 = hf::tools::parse_line_entry(out);
+    ASSERT_EQ(hfp2.second.get_minimizer().algo, hf::minimizer_opts::algorithm::gsl_lm);
+    ASSERT_EQ(hfp2.second.get_minimizer().tolerance, 0.01);
+    ASSERT_EQ(hfp2.second.get_minimizer().max_calls, 500);
+
+    hfp.second.set_minimizer(hf::minimizer_opts());
+    out = hf::tools::format_line_entry(hfp.first, &hfp.second, hf::format_version::v2);
+    ASSERT_STREQ(out.c_str(), " hist_1\t1 10 0 gaus(0) |  1  2 : 1 3  3");
+
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | minimizer=foo"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | foo=1"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | strategy"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | strategy=abc"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | strategy=7"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | calls=-5"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | calls=5x"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | tolerance=-0.1"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | budget_time=nan"), hf::format_error);
+    ASSERT_THROW(hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | seed=2"), hf::format_error);
+}
+
+TEST(TestsParserV2, BudgetOptions)
+{
+    auto hfp = hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | budget_calls=200 budget_time=0.5",
+                                           hf::format_version::v2);
+
+    ASSERT_TRUE(hfp.second.get_minimizer().is_default());
+    ASSERT_EQ(hfp.second.get_fit_budget().max_calls, 200);
+    ASSERT_EQ(hfp.second.get_fit_budget().max_time, 0.5);
+
+    auto out = hf::tools::format_line_entry(hfp.first, &hfp.second, hf::format_version::v2);
+    ASSERT_STREQ(out.c_str(), " hist_1\t1 10 0 gaus(0) |  1  2  3 | budget_calls=200 budget_time=0.5");
+
+    // the values are written in the shortest form which reads back exactly
+    hfp.second.set_fit_budget(hf::fit_budget{0, 1.2345678901234});
+    hfp.second.set_minimizer(hf::minimizer_opts{hf::minimizer_opts::algorithm::standard, -1, 1.0e-7 / 3, 0});
+    out = hf::tools::format_line_entry(hfp.first, &hfp.second, hf::format_version::v2);
+    const auto hfp2 = hf::tools::parse_line_entry(out);
+    ASSERT_EQ(hfp2.second.get_fit_budget().max_time, 1.2345678901234);
+    ASSERT_EQ(hfp2.second.get_minimizer().tolerance, 1.0e-7 / 3);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include "details.hpp"
+#include "objective.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+/// Gaussian counts in 100 bins over (0, 10)
+struct gaus_bins
+{
+    std::vector<double> edges;
+    std::vector<double> centers;
+    std::vector<double> counts;
+
+    gaus_bins()
+    {
+        for (int i = 0; i <= 100; ++i)
+            edges.push_back(0.1 * i);
+        for (int i = 0; i < 100; ++i)
+        {
+            const auto x = 0.5 * (edges[i] + edges[i + 1]);
+            centers.push_back(x);
+            counts.push_back(std::round(1000. * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25)));
+        }
+    }
+};
+
+auto make_gaus_entry() -> hf::entry
+{
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+    return hfp;
+}
+} // namespace
+
+TEST(TestsRawFit, BinsSnapshot)
+{
+    gaus_bins bins;
+    const hf::detail::raw_bins raw{bins.counts.size(), bins.edges.data(), bins.counts.data(), nullptr};
+
+    hf::detail::bin_data data;
+    hf::detail::make_bin_data(&raw, 4, 6, hf::detail::fit_statistic::likelihood, data);
+    ASSERT_EQ(data.size(), 20u);
+    ASSERT_NEAR(data.x.front(), 4.05, 1e-9);
+    ASSERT_NEAR(data.x.back(), 5.95, 1e-9);
+    ASSERT_NEAR(data.ey[10], std::sqrt(bins.counts[50]), 1e-9);
+
+    hf::detail::make_bin_data(&raw, 4, 6, hf::detail::fit_statistic::likelihood, data, 8);
+    ASSERT_EQ(data.size(), 3u);
+    ASSERT_NEAR(data.x[0], 4.4, 1e-9);
+
+    hf::detail::make_bin_data(&raw, 0, 10, hf::detail::fit_statistic::chi2, data);
+    ASSERT_LT(data.size(), 100u);
+}
+
+TEST(TestsRawFit, PointsSnapshot)
+{
+    const double x[] = {1, 2, 3, 4};
+    const double y[] = {2, 4, 6, 8};
+    const double ey[] = {0.5, 0, 0.5, 0.5};
+    const hf::detail::raw_points raw{4, x, y, ey};
+
+    hf::detail::bin_data data;
+    hf::detail::make_bin_data(&raw, 1.5, 4, hf::detail::fit_statistic::chi2, data);
+    ASSERT_EQ(data.size(), 3u);
+    ASSERT_EQ(data.ey[0], 1.0);
+    ASSERT_EQ(data.ey[1], 0.5);
+}
+
+TEST(TestsRawFit, FitBins)
+{
+    gaus_bins bins;
+    auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    ASSERT_TRUE(fitter.fit_bins(&hfp, "raw_bins", bins.counts.size(), bins.edges.data(), bins.counts.data()));
+    ASSERT_NEAR(hfp.param(0).value, 1000, 10);
+    ASSERT_NEAR(hfp.param(1).value, 5.0, 0.01);
+    ASSERT_NEAR(hfp.param(2).value, 0.5, 0.01);
+    ASSERT_NEAR(hfp.get_function_object().GetParameter(1), 5.0, 0.01);
+}
+
+TEST(TestsRawFit, FitPoints)
+{
+    gaus_bins bins;
+    std::vector<double> errors;
+    for (auto c : bins.counts)
+        errors.push_back(c > 0 ? std::sqrt(c) : 1.0);
+
+    auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    fitter.set_fit_stats(true);
+    ASSERT_TRUE(fitter.fit_points(&hfp, "raw_points", bins.centers.size(), bins.centers.data(), bins.counts.data(),
+                                  errors.data()));
+    ASSERT_NEAR(hfp.param(1).value, 5.0, 0.01);
+    ASSERT_EQ(fitter.get_fit_stats().size(), 1u);
+}
+
+TEST(TestsRawFit, FailedFitRestoresParameters)
+{
+    gaus_bins bins;
+    auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    fitter.set_fit_budget(hf::fit_budget{5, 0});
+    ASSERT_FALSE(fitter.fit_bins(&hfp, "raw_budget", bins.counts.size(), bins.edges.data(), bins.counts.data()));
+    ASSERT_TRUE(hfp.get_flag_budget_exceeded());
+    ASSERT_EQ(hfp.param(1).value, 4.8);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_config.h"
+
+#include "details.hpp"
+#include "registry.hpp"
+
+#include <TROOT.h>
+
+#include <fmt/core.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+auto make_entry(double value) -> hf::entry
+{
+    hf::entry hfp(0, 10);
+    hfp.add_function("pol0(0)");
+    hfp.set_param(0, value);
+    return hfp;
+}
+} // namespace
+
+TEST(TestsRegistry, InsertFindReplace)
+{
+    hf::detail::registry reg;
+    ASSERT_EQ(reg.find("h1"), nullptr);
+
+    auto* first = reg.insert("h1", make_entry(1));
+    ASSERT_EQ(reg.find("h1"), first);
+    ASSERT_EQ(reg.size(), 1u);
+
+    // the replaced entry is not changed and survives as long as it is shared
+    auto shared = reg.find_shared("h1");
+    auto* second = reg.insert("h1", make_entry(2));
+    ASSERT_NE(second, first);
+    ASSERT_EQ(reg.find("h1"), second);
+    ASSERT_EQ(shared->param(0).value, 1);
+    ASSERT_EQ(second->param(0).value, 2);
+    ASSERT_EQ(reg.size(), 1u);
+
+    // the name is registered already, the given entry is not used
+    ASSERT_EQ(reg.find_or_insert("h1", make_entry(3)).get(), second);
+    ASSERT_EQ(reg.find_or_insert("h2", make_entry(3))->param(0).value, 3);
+    ASSERT_EQ(reg.size(), 2u);
+
+    reg.clear();
+    ASSERT_EQ(reg.find("h1"), nullptr);
+    ASSERT_EQ(shared->param(0).value, 1);
+}
+
+TEST(TestsRegistry, NestedRead)
+{
+    hf::detail::registry reg;
+    reg.insert("h1", make_entry(1));
+
+    const auto found = reg.read(
+        [&](const hf::detail::registry::map_type& map)
+        {
+            reg.insert("h2", make_entry(2));
+            // the outer version is still the one without h2
+            return map.size() == 1 and reg.find("h2") != nullptr;
+        });
+    ASSERT_TRUE(found);
+    ASSERT_EQ(reg.size(), 2u);
+}
+
+TEST(TestsRegistry, PersistentMap)
+{
+    constexpr int count = 1000;
+    std::vector<int> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = (i * 7919) % count;
+
+    hf::detail::entry_map map;
+    for (const auto i : order)
+        map = map.insert(fmt::format("h_{:04d}", i), std::make_shared<hf::entry>(make_entry(i)));
+    ASSERT_EQ(map.size(), static_cast<size_t>(count));
+
+    // ordered by the name, as std::map
+    int expected = 0;
+    for (const auto& it : map)
+    {
+        ASSERT_EQ(it.first, fmt::format("h_{:04d}", expected));
+        ASSERT_EQ(it.second->param(0).value, expected++);
+    }
+    ASSERT_EQ(expected, count);
+
+    // the derived versions do not change the original one
+    const auto replaced = map.insert("h_0500", std::make_shared<hf::entry>(make_entry(-1)));
+    const auto erased = map.erase("h_0500").erase("h_0501").erase("h_missing");
+    ASSERT_EQ(map.find("h_0500")->second->param(0).value, 500);
+    ASSERT_EQ(replaced.find("h_0500")->second->param(0).value, -1);
+    ASSERT_EQ(replaced.size(), static_cast<size_t>(count));
+    ASSERT_EQ(erased.size(), static_cast<size_t>(count - 2));
+    ASSERT_TRUE(erased.find("h_0500") == erased.end());
+    ASSERT_EQ(std::next(erased.find("h_0499"))->first, "h_0502");
+    ASSERT_EQ(std::distance(erased.begin(), erased.end()), count - 2);
+}
+
+TEST(TestsRegistry, ReaderSlotsReused)
+{
+    hf::detail::registry reg;
+    reg.insert("h1", make_entry(1));
+
+    // the slots of the finished threads are reused
+    for (int i = 0; i < 50; ++i)
+    {
+        std::thread reader([&] { ASSERT_NE(reg.find("h1"), nullptr); });
+        reader.join();
+    }
+    ASSERT_LE(reg.reader_slots(), 2u);
+}
+
+TEST(TestsRegistry, ConcurrentReadersSingleWriter)
+{
+    constexpr int entries = 50;
+    const auto filename = fmt::format("{:s}registry_input.txt", build_path);
+    {
+        std::ofstream file(filename);
+        for (int i = 0; i < entries; ++i)
+            file << fmt::format(" h_{:d}\t0 10 0 pol0(0) | {:d}\n", i, i);
+    }
+
+    // the last owner of a replaced entry, possibly a reader, destroys its functions
+    ROOT::EnableThreadSafety();
+
+    hf::fitter fitter;
+    ASSERT_TRUE(fitter.init_from_file(filename));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> missing{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back(
+            [&]
+            {
+                while (!stop)
+                {
+                    // the published entries are never changed, so their values may be read
+                    for (int i = 0; i < entries; ++i)
+                    {
+                        const auto hfp = fitter.find_fit_shared(fmt::format("h_{:d}", i).c_str());
+                        if (!hfp) { ++missing; }
+                        else if (std::lround(hfp->param(0).value) % 1000 != i) { ++missing; }
+                    }
+                }
+            });
+    }
+
+    for (int round = 0; round < 200; ++round)
+    {
+        const auto i = round % entries;
+        auto* hfp = fitter.insert_parameter(fmt::format("h_{:d}", i), make_entry(i + 1000 * (round % 3)));
+        ASSERT_EQ(fitter.find_fit(fmt::format("h_{:d}", i).c_str()), hfp);
+        ASSERT_EQ(std::lround(hfp->param(0).value) % 1000, i);
+        if (round % 50 == 0) { ASSERT_TRUE(fitter.init_from_file(filename)); }
+    }
+
+    stop = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    // entries are replaced, never removed, so every lookup must succeed
+    ASSERT_EQ(missing, 0);
+    std::remove(filename.c_str());
+}
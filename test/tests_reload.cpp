@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_config.h"
+
+#include <TH1.h>
+#include <TROOT.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+auto write_file(const std::string& filename, const std::string& content) -> void
+{
+    // replaced by rename, as editors save
+    const auto temp = filename + ".tmp";
+    std::ofstream(temp) << content;
+    std::rename(temp.c_str(), filename.c_str());
+}
+
+auto read_file(const std::string& filename) -> std::string
+{
+    std::ifstream file(filename);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+} // namespace
+
+TEST(TestsReload, ChangedLinesOnly)
+{
+    const auto input = tests_bin_path + "reload_input.txt";
+    write_file(input, " h_a\t0 10 0 pol0(0) | 1\n"
+                      " h_b\t0 10 0 gaus(0) | 10 5 1\n"
+                      " h_c\t0 10 0 pol0(0) | 3\n");
+
+    hf::fitter fitter;
+    ASSERT_TRUE(fitter.init_from_file(input));
+    ASSERT_EQ(fitter.find_fit("h_c")->param(0).value, 3);
+
+    const auto h_a = fitter.find_fit_shared("h_a");
+    const auto h_b = fitter.find_fit_shared("h_b");
+    h_a->set_param(0, 1.5); // e.g. a fit result, kept as the line is not changed
+    fitter.insert_parameter("h_x", hf::entry(0, 10));
+
+    write_file(input, " h_a\t0 10 0 pol0(0) | 1\n"
+                      " h_b\t0 10 0 gaus(0) | 20 5 1\n"
+                      " h_d\t0 10 0 gaus(0) | 30 5 1\n");
+
+    fitter.set_trace(true);
+    ASSERT_TRUE(fitter.reload());
+
+    ASSERT_EQ(fitter.find_fit_shared("h_a"), h_a);
+    ASSERT_EQ(fitter.find_fit("h_a")->param(0).value, 1.5);
+    ASSERT_NE(fitter.find_fit_shared("h_b"), h_b); // replaced, the old entry is not changed
+    ASSERT_EQ(h_b->param(0).value, 10);
+    ASSERT_EQ(fitter.find_fit("h_b")->param(0).value, 20);
+    ASSERT_EQ(fitter.find_fit("h_c"), nullptr);
+    ASSERT_EQ(fitter.find_fit("h_d")->param(0).value, 30);
+    ASSERT_NE(fitter.find_fit("h_x"), nullptr);
+
+    // the formulas did not change, so nothing was compiled
+    const auto trace = tests_bin_path + "reload_trace.json";
+    ASSERT_TRUE(fitter.write_trace(trace));
+    const auto content = read_file(trace);
+    ASSERT_NE(content.find("\"reload\""), std::string::npos);
+    ASSERT_EQ(content.find("\"compile\""), std::string::npos);
+
+    // a broken line leaves the parameters untouched
+    write_file(input, " h_a\t0 10 0 pol0(0) | 2\n"
+                      " h_b\t0 10 gaus(0) | 20 5 1\n");
+    ASSERT_THROW(fitter.reload(), hf::format_error);
+    ASSERT_EQ(fitter.find_fit_shared("h_a"), h_a);
+    ASSERT_NE(fitter.find_fit("h_d"), nullptr);
+
+    std::remove(input.c_str());
+    std::remove(trace.c_str());
+}
+
+TEST(TestsReload, WhileFitting)
+{
+    const auto input = tests_bin_path + "reload_fitting_input.txt";
+    write_file(input, " h_f\t1 9 0 gaus(0) | 500 4 1\n");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    ASSERT_TRUE(fitter.init_from_file(input));
+
+    TH1D hist("h_f", "", 100, 0, 10);
+    hist.SetDirectory(nullptr);
+    for (int i = 1; i <= hist.GetNbinsX(); ++i)
+    {
+        const auto x = hist.GetBinCenter(i);
+        hist.SetBinContent(i, std::round(1000 * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25)));
+    }
+
+    // the entries replaced by the reloads are destroyed on this thread while the other one fits
+    ROOT::EnableThreadSafety();
+
+    // the entry taken before the reloads is fitted while the file changes
+    const auto hfp = fitter.find_fit_shared("h_f");
+    std::atomic<bool> done{false};
+    std::atomic<int> fits{0};
+    std::thread worker(
+        [&]()
+        {
+            while (!done or fits == 0)
+            {
+                fitter.fit(hfp.get(), &hist);
+                ++fits;
+            }
+        });
+
+    for (int i = 0; i < 20; ++i)
+    {
+        write_file(input, " h_f\t1 9 0 gaus(0) | " + std::to_string(500 + i) + " 4 1\n");
+        ASSERT_TRUE(fitter.reload());
+    }
+    done = true;
+    worker.join();
+
+    ASSERT_GT(fits, 0);
+    ASSERT_NE(fitter.find_fit_shared("h_f"), hfp);
+    ASSERT_NEAR(hfp->get_param(0).value, 1000, 10);
+
+    // the last reload is registered, the next fit starts from it
+    write_file(input, " h_f\t1 9 0 gaus(0) | 700 4 1\n");
+    ASSERT_TRUE(fitter.reload());
+    auto* reloaded = fitter.find_fit("h_f");
+    ASSERT_EQ(reloaded->get_param(0).value, 700);
+    ASSERT_TRUE(fitter.fit(reloaded, &hist));
+    ASSERT_NEAR(reloaded->get_param(0).value, 1000, 10);
+
+    std::remove(input.c_str());
+}
+
+TEST(TestsReload, Watch)
+{
+    const auto input = tests_bin_path + "watch_input.txt";
+    write_file(input, " h_w\t0 10 0 pol0(0) | 1\n");
+
+    hf::fitter fitter;
+    ASSERT_TRUE(fitter.init_from_file(input));
+
+#ifdef __linux__
+    ASSERT_TRUE(fitter.start_watch());
+    ASSERT_TRUE(fitter.is_watching());
+
+    write_file(input, " h_w\t0 10 0 pol0(0) | 2\n");
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (fitter.find_fit_shared("h_w")->get_param(0).value != 2 and std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(fitter.find_fit_shared("h_w")->get_param(0).value, 2);
+
+    fitter.stop_watch();
+    ASSERT_FALSE(fitter.is_watching());
+#else
+    ASSERT_FALSE(fitter.start_watch());
+#endif
+
+    std::remove(input.c_str());
+}
+
+TEST(TestsReload, WatchOwnExport)
+{
+    const auto input = tests_bin_path + "watch_export_input.txt";
+    const auto aux = tests_bin_path + "watch_export_aux.txt";
+    std::remove(aux.c_str());
+    write_file(input, " h_e\t1 9 0 gaus(0) | 500 4 1\n");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    ASSERT_TRUE(fitter.init_from_file(input, aux));
+
+    TH1D hist("h_e", "", 100, 0, 10);
+    hist.SetDirectory(nullptr);
+    for (int i = 1; i <= hist.GetNbinsX(); ++i)
+    {
+        const auto x = hist.GetBinCenter(i);
+        hist.SetBinContent(i, std::round(1000 * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25)));
+    }
+
+#ifdef __linux__
+    ASSERT_TRUE(fitter.start_watch());
+    ASSERT_TRUE(fitter.fit(&hist).first);
+    ASSERT_TRUE(fitter.find_fit("h_e")->get_fit_result().is_valid());
+    const auto fitted = fitter.find_fit("h_e")->get_param(0).value;
+
+    // the watcher sees the export, the entries it was written from are kept
+    ASSERT_TRUE(fitter.export_to_file());
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ASSERT_TRUE(fitter.find_fit("h_e")->get_fit_result().is_valid());
+    ASSERT_EQ(fitter.find_fit("h_e")->get_param(0).value, fitted);
+
+    // a change of the exported file is reloaded
+    write_file(aux, " h_e\t1 9 0 gaus(0) | 700 4 1\n");
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (fitter.find_fit_shared("h_e")->get_param(0).value != 700 and std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(fitter.find_fit_shared("h_e")->get_param(0).value, 700);
+
+    fitter.stop_watch();
+#else
+    ASSERT_FALSE(fitter.start_watch());
+#endif
+
+    std::remove(input.c_str());
+    std::remove(aux.c_str());
+}
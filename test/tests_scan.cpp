@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include <TGraph.h>
+#include <TH1.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+namespace
+{
+auto make_gaus_hist(const char* name) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name, "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(1000. * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+
+auto make_gaus_entry() -> hf::entry
+{
+    hf::entry hfp(2, 8);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 4.8);
+    hfp.set_param(2, 0.7);
+    return hfp;
+}
+} // namespace
+
+TEST(TestsScan, Profile)
+{
+    auto hist = make_gaus_hist("h_scan");
+    const auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    const auto result = fitter.scan(hfp, hist.get(), 1, 4.95, 5.05, 21, "BQ", 4);
+
+    ASSERT_EQ(result.par_id, 1);
+    ASSERT_EQ(result.best_status, 0);
+    ASSERT_NEAR(result.best_value, 5.0, 0.01);
+    ASSERT_EQ(result.size(), 21u);
+    ASSERT_DOUBLE_EQ(result.points.front(), 4.95);
+    ASSERT_DOUBLE_EQ(result.points.back(), 5.05);
+
+    // model entry is not modified
+    ASSERT_EQ(hfp.param(1).value, 4.8);
+
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        ASSERT_EQ(result.status[i], 0);
+        ASSERT_EQ(result.values[1][i], result.points[i]);
+        ASSERT_GE(result.objective[i], result.best_objective - 1e-6);
+    }
+
+    // parabolic profile with the minimum at the unconstrained fit
+    const auto min_it = std::min_element(result.objective.begin(), result.objective.end());
+    const auto min_point = static_cast<size_t>(std::distance(result.objective.begin(), min_it));
+    ASSERT_NEAR(result.points[min_point], result.best_value, 0.005);
+    ASSERT_GT(result.objective.front(), *min_it + 1);
+    ASSERT_GT(result.objective.back(), *min_it + 1);
+
+    const auto graph = result.make_graph();
+    ASSERT_EQ(graph->GetN(), 21);
+}
+
+TEST(TestsScan, SerialMatchesParallel)
+{
+    auto hist = make_gaus_hist("h_scan_serial");
+    const auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    const auto serial = fitter.scan(hfp, hist.get(), 2, 0.45, 0.55, 11, "BQ", 1);
+    const auto parallel = fitter.scan(hfp, hist.get(), 2, 0.45, 0.55, 11, "BQ", 3);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); ++i)
+        ASSERT_NEAR(serial.objective[i], parallel.objective[i], 1e-3);
+}
+
+TEST(TestsScan, Arguments)
+{
+    auto hist = make_gaus_hist("h_scan_args");
+    const auto hfp = make_gaus_entry();
+
+    hf::fitter fitter;
+    ASSERT_THROW(fitter.scan(hfp, hist.get(), 3, 0, 1, 5), hf::index_error);
+    ASSERT_THROW(fitter.scan(hfp, hist.get(), -1, 0, 1, 5), hf::index_error);
+
+    const auto empty = fitter.scan(hfp, hist.get(), 1, 4.9, 5.1, 0);
+    ASSERT_EQ(empty.size(), 0u);
+    ASSERT_EQ(empty.best_status, 0);
+
+    const auto single = fitter.scan(hfp, hist.get(), 1, 5.0, 5.1, 1);
+    ASSERT_EQ(single.size(), 1u);
+    ASSERT_DOUBLE_EQ(single.points[0], 5.0);
+}
+
+TEST(TestsScan, GraphWithoutMinimum)
+{
+    hf::scan_result result;
+    result.points = {1.0, 2.0, 3.0};
+    result.objective = {12.0, 10.0, 11.0};
+    result.status = {0, 0, -1};
+
+    // unconstrained fit failed or aborted by the budget, its objective is not a minimum
+    auto graph = result.make_graph();
+    ASSERT_EQ(graph->GetN(), 2);
+    ASSERT_DOUBLE_EQ(graph->GetY()[0], 2.0);
+    ASSERT_DOUBLE_EQ(graph->GetY()[1], 0.0);
+
+    // a point below the unconstrained minimum
+    result.best_status = 0;
+    result.best_objective = 10.5;
+    graph = result.make_graph();
+    ASSERT_DOUBLE_EQ(graph->GetY()[1], 0.0);
+
+    result.best_objective = 9.0;
+    graph = result.make_graph();
+    ASSERT_DOUBLE_EQ(graph->GetY()[1], 1.0);
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include <TH1.h>
+#include <TRandom3.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+
+namespace
+{
+auto make_peak_hist(const char* name) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name, "", 200, 0, 20);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 200; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = 500. * std::exp(-0.5 * (x - 12.) * (x - 12.) / 0.64) + std::exp(6. - 0.2 * x);
+        hist->SetBinContent(i, std::round(content));
+        hist->SetBinError(i, std::sqrt(std::round(content)));
+    }
+    return hist;
+}
+
+/// Peak of the given mean and sigma over exponential background with Poisson fluctuations.
+auto make_random_peak(TRandom3& rng, const std::string& name, double mean, double sigma) -> std::unique_ptr<TH1D>
+{
+    const auto amplitude = rng.Uniform(300, 1000);
+    const auto slope = rng.Uniform(-0.3, -0.1);
+
+    auto hist = std::make_unique<TH1D>(name.c_str(), "", 200, 0, 20);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 200; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto expected =
+            amplitude * std::exp(-0.5 * (x - mean) * (x - mean) / (sigma * sigma)) + std::exp(5. + slope * x);
+        const auto content = static_cast<double>(rng.Poisson(expected));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(std::max(content, 1.)));
+    }
+    return hist;
+}
+} // namespace
+
+TEST(TestsSeeding, GausExpo)
+{
+    auto hist = make_peak_hist("h_seed");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+
+    auto hfp = hf::tools::parse_line_entry("h_seed 0 20 0 gaus(0) expo(3) | 1 1 1 0 0");
+    hfp.second.set_auto_seed(true);
+    ASSERT_TRUE(hfp.second.get_flag_auto_seed());
+
+    ASSERT_TRUE(fitter.fit(&hfp.second, hist.get()));
+
+    ASSERT_NEAR(hfp.second.param(0).value, 500, 10);
+    ASSERT_NEAR(hfp.second.param(1).value, 12, 0.01);
+    ASSERT_NEAR(hfp.second.param(2).value, 0.8, 0.01);
+    ASSERT_NEAR(hfp.second.param(3).value, 6, 0.05);
+    ASSERT_NEAR(hfp.second.param(4).value, -0.2, 0.01);
+}
+
+TEST(TestsSeeding, FixedParameter)
+{
+    auto hist = make_peak_hist("h_seed_fixed");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+
+    auto hfp = hf::tools::parse_line_entry("h_seed_fixed 0 20 0 gaus(0) expo(3) | 1 11 f 1 0 0");
+    hfp.second.set_auto_seed(true);
+
+    fitter.fit(&hfp.second, hist.get());
+    ASSERT_EQ(hfp.second.param(1).value, 11);
+}
+
+TEST(TestsSeeding, OptionRoundTrip)
+{
+    auto hfp = hf::tools::parse_line_entry("hist_1 1 10 0 gaus(0) | 1 2 3 | seed=1", hf::format_version::v2);
+    ASSERT_TRUE(hfp.second.get_flag_auto_seed());
+
+    auto out = hf::tools::format_line_entry(hfp.first, &hfp.second, hf::format_version::v2);
+    ASSERT_STREQ(out.c_str(), " hist_1\t1 10 0 gaus(0) |  1  2  3 | seed=1");
+}
+
+
+TEST(TestsSeeding, RejectedFitKeepsParameters)
+{
+    auto hist = make_peak_hist("h_seed_rejected");
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_qa_checker([](const hf::params_vector&, double, const hf::params_vector&, double,
+                             const TFitResultPtr&) { return -1; });
+
+    auto hfp = hf::tools::parse_line_entry("h_seed_rejected 0 20 0 gaus(0) expo(3) | 1 1 1 0 0");
+    hfp.second.set_auto_seed(true);
+
+    // the seeds are not stored when the fit is rejected
+    fitter.fit(&hfp.second, hist.get());
+    ASSERT_EQ(hfp.second.param(0).value, 1);
+    ASSERT_EQ(hfp.second.param(1).value, 1);
+    ASSERT_EQ(hfp.second.param(2).value, 1);
+    ASSERT_EQ(hfp.second.param(3).value, 0);
+    ASSERT_EQ(hfp.second.param(4).value, 0);
+    ASSERT_FALSE(hfp.second.get_fit_result().is_valid());
+}
+
+TEST(TestsSeeding, ConvergenceRate)
+{
+    // peaks anywhere in the range, all fitted from the same generic starting point
+    constexpr int count = 40;
+    TRandom3 rng(2718);
+
+    int converged[2] = {0, 0};
+    for (int i = 0; i < count; ++i)
+    {
+        const auto mean = rng.Uniform(3, 17);
+        const auto sigma = rng.Uniform(0.4, 1.2);
+        auto hist = make_random_peak(rng, fmt::format("h_seed_rate_{:d}", i), mean, sigma);
+
+        for (int seed = 0; seed < 2; ++seed)
+        {
+            hf::fitter fitter;
+            fitter.set_fit_engine(hf::fitter::fit_engine::native);
+
+            auto hfp = hf::tools::parse_line_entry(" h\t0 20 0 gaus(0) expo(3) | 100 10 1 0 0", hf::format_version::v2);
+            hfp.second.set_auto_seed(seed != 0);
+
+            const auto fitted = fitter.fit(&hfp.second, hist.get()) and hfp.second.get_fit_result().is_valid();
+            if (fitted and std::abs(hfp.second.param(1).value - mean) < 0.1 * sigma and
+                std::abs(std::abs(hfp.second.param(2).value) - sigma) < 0.1 * sigma)
+            {
+                ++converged[seed];
+            }
+        }
+    }
+
+    fmt::print("[ SEEDING  ] converged without seeding {:d}/{:d}, with seeding {:d}/{:d}\n", converged[0], count,
+               converged[1], count);
+    RecordProperty("converged_unseeded", converged[0]);
+    RecordProperty("converged_seeded", converged[1]);
+
+    ASSERT_GT(converged[1], converged[0]);
+    ASSERT_GE(converged[1], count * 9 / 10);
+}
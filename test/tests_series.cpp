@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include <TH1.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+auto make_gaus_hist(const std::string& name, double mean) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name.c_str(), "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        const auto content = std::round(1000. * std::exp(-0.5 * (x - mean) * (x - mean) / 0.25));
+        hist->SetBinContent(i, content);
+        hist->SetBinError(i, std::sqrt(content));
+    }
+    return hist;
+}
+
+auto make_generic_entry() -> hf::entry
+{
+    hf::entry hfp(1, 9);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 500);
+    hfp.set_param(1, 4.0);
+    hfp.set_param(2, 1.0);
+    return hfp;
+}
+
+auto make_series(const std::string& prefix, size_t count) -> std::vector<std::unique_ptr<TH1D>>
+{
+    std::vector<std::unique_ptr<TH1D>> hists;
+    for (size_t i = 0; i < count; ++i)
+        hists.push_back(make_gaus_hist(prefix + std::to_string(i), 5.0 + 0.02 * static_cast<double>(i)));
+    return hists;
+}
+
+auto raw(const std::vector<std::unique_ptr<TH1D>>& hists) -> std::vector<TH1*>
+{
+    std::vector<TH1*> ptrs;
+    for (const auto& hist : hists)
+        ptrs.push_back(hist.get());
+    return ptrs;
+}
+} // namespace
+
+TEST(TestsSeries, WarmStart)
+{
+    const auto hists = make_series("h_series_", 10);
+    const auto cold_hists = make_series("h_series_cold_", 10);
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_generic_entry(make_generic_entry());
+
+    const auto results = fitter.fit_series(raw(hists));
+    ASSERT_EQ(results.size(), 10u);
+
+    unsigned int warm_calls = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        ASSERT_TRUE(results[i].first);
+        ASSERT_TRUE(results[i].second->get_fit_result().is_valid());
+        ASSERT_NEAR(results[i].second->param(1).value, 5.0 + 0.02 * static_cast<double>(i), 0.01);
+        warm_calls += results[i].second->get_fit_result().ncalls;
+    }
+
+    unsigned int cold_calls = 0;
+    for (const auto& hist : cold_hists)
+    {
+        const auto result = fitter.fit(hist.get());
+        ASSERT_TRUE(result.first);
+        cold_calls += result.second->get_fit_result().ncalls;
+    }
+
+    ASSERT_LT(warm_calls, cold_calls);
+}
+
+TEST(TestsSeries, FallbackAfterFailure)
+{
+    auto hists = make_series("h_series_fail_", 3);
+    hists[1]->Reset();
+
+    hf::fitter fitter;
+    fitter.set_fit_engine(hf::fitter::fit_engine::native);
+    fitter.set_generic_entry(make_generic_entry());
+
+    const auto results = fitter.fit_series(raw(hists));
+    ASSERT_EQ(results.size(), 3u);
+    ASSERT_TRUE(results[0].first);
+    ASSERT_FALSE(results[1].first);
+    ASSERT_TRUE(results[2].first);
+
+    // the failed entry keeps the stored parameters, not the ones of the previous histogram
+    ASSERT_EQ(results[1].second->param(1).value, 4.0);
+    ASSERT_EQ(results[1].second->param(2).value, 1.0);
+
+    ASSERT_NEAR(results[2].second->param(1).value, 5.04, 0.01);
+}
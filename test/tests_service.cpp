@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_client.hpp"
+#include "hellofitty_service.hpp"
+
+#include "service_protocol.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+auto socket_path(const char* name) -> std::string
+{
+    return (std::filesystem::temp_directory_path() / (name + std::to_string(::getpid()) + ".sock")).string();
+}
+
+auto gaus_counts() -> std::vector<double>
+{
+    std::vector<double> counts(100);
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        const auto x = 0.05 + 0.1 * static_cast<double>(i);
+        counts[i] = std::round(1000. * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25));
+    }
+    return counts;
+}
+
+/// Fitter with a single entry served on own thread for the lifetime of the object.
+struct running_service
+{
+    hf::fitter fitter;
+    hf::service service{fitter};
+    std::string path;
+    std::thread thread;
+
+    explicit running_service(const char* name) : path(socket_path(name))
+    {
+        fitter.set_verbose(false);
+
+        hf::entry hfp(2, 8);
+        hfp.add_function("gaus(0)");
+        hfp.set_param(0, 800);
+        hfp.set_param(1, 4.8);
+        hfp.set_param(2, 0.7);
+        fitter.insert_parameter("h_service", hfp);
+
+        service.listen(path);
+        thread = std::thread([this] { service.run(); });
+    }
+
+    ~running_service()
+    {
+        service.stop();
+        thread.join();
+    }
+};
+} // namespace
+
+TEST(TestsService, Fit)
+{
+    running_service server("hf_service_fit_");
+
+    hf::service_client client(server.path);
+    ASSERT_TRUE(client.ping());
+
+    const auto reply = client.fit("h_service", 0, 10, gaus_counts());
+    ASSERT_TRUE(reply.ok) << reply.error;
+    ASSERT_TRUE(reply.is_valid());
+    ASSERT_EQ(reply.values.size(), 3u);
+    ASSERT_EQ(reply.errors.size(), 3u);
+    ASSERT_NEAR(reply.values[0], 1000, 10);
+    ASSERT_NEAR(reply.values[1], 5.0, 0.01);
+    ASSERT_NEAR(reply.values[2], 0.5, 0.01);
+    ASSERT_GT(reply.errors[1], 0);
+    ASSERT_GT(reply.ndf, 0);
+
+    // the served entry keeps its parameters and is not fitted, the same request gives the same reply
+    ASSERT_EQ(server.fitter.find_fit("h_service")->param(1).value, 4.8);
+    ASSERT_EQ(server.fitter.find_fit("h_service")->get_fit_result().status, -1);
+    ASSERT_EQ(server.fitter.find_fit("h_service")->get_fit_result().ndf, 0);
+    const auto again = client.fit("h_service", 0, 10, gaus_counts());
+    ASSERT_EQ(again.values, reply.values);
+
+    ASSERT_EQ(server.service.get_requests_count(), 3u);
+}
+
+TEST(TestsService, Errors)
+{
+    running_service server("hf_service_errors_");
+
+    hf::service_client client(server.path);
+
+    const auto reply = client.fit("h_missing", 0, 10, gaus_counts());
+    ASSERT_FALSE(reply.ok);
+    ASSERT_FALSE(reply.is_valid());
+    ASSERT_NE(reply.error.find("h_missing"), std::string::npos);
+
+    ASSERT_THROW(client.fit("h_service", {0, 1}, {1, 2}), std::invalid_argument);
+
+    // the connection survives the errors
+    ASSERT_TRUE(client.ping());
+
+    ASSERT_THROW(hf::service_client("/nonexistent/hf_service.sock"), std::runtime_error);
+}
+
+TEST(TestsService, ManyClients)
+{
+    running_service server("hf_service_clients_");
+
+    std::vector<std::thread> threads;
+    std::vector<int> valid(4, 0);
+    for (size_t i = 0; i < valid.size(); ++i)
+    {
+        threads.emplace_back(
+            [&, i]
+            {
+                hf::service_client client(server.path);
+                for (int r = 0; r < 5; ++r)
+                    valid[i] += client.fit("h_service", 0, 10, gaus_counts()).is_valid();
+            });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto count : valid)
+        ASSERT_EQ(count, 5);
+}
+
+TEST(TestsService, ClientNotReading)
+{
+    running_service server("hf_service_not_reading_");
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, server.path.c_str(), sizeof(address.sun_path) - 1);
+    const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    hf::detail::service_configure(fd);
+    ASSERT_EQ(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+
+    // floods the service with requests and never reads the replies, blocks once the service stops reading them
+    std::thread flood(
+        [fd]
+        {
+            const std::string requests = [] {
+                std::string data;
+                for (int i = 0; i < 10000; ++i)
+                    data += "PING\n";
+                return data;
+            }();
+            while (::send(fd, requests.data(), requests.size(), hf::detail::service_send_flags) > 0) {}
+        });
+
+    // the other clients are still served
+    hf::service_client client(server.path);
+    for (int i = 0; i < 20; ++i)
+        ASSERT_TRUE(client.ping());
+    ASSERT_TRUE(client.fit("h_service", 0, 10, gaus_counts()).is_valid());
+
+    ::shutdown(fd, SHUT_RDWR);
+    flood.join();
+    ::close(fd);
+}
+
+TEST(TestsService, RejectedFitErrors)
+{
+    running_service server("hf_service_rejected_");
+    server.fitter.set_qa_checker([](const hf::params_vector&, double, const hf::params_vector&, double,
+                                    const TFitResultPtr&) { return -1; });
+
+    hf::service_client client(server.path);
+    const auto reply = client.fit("h_service", 0, 10, gaus_counts());
+    ASSERT_TRUE(reply.ok) << reply.error;
+    ASSERT_LT(reply.qa, 0);
+    ASSERT_FALSE(reply.is_valid());
+    for (const auto error : reply.errors)
+        ASSERT_EQ(error, 0);
+}
+
+TEST(TestsService, RefusesOtherFiles)
+{
+    const auto path = socket_path("hf_service_file_");
+    std::ofstream(path) << "not a socket\n";
+
+    hf::fitter fitter;
+    hf::service service(fitter);
+    ASSERT_THROW(service.listen(path), std::runtime_error);
+    ASSERT_THROW(service.run(), std::logic_error);
+    ASSERT_TRUE(std::filesystem::exists(path));
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+
+#include <TGraphErrors.h>
+#include <TH2.h>
+
+#include <cmath>
+#include <memory>
+
+namespace
+{
+/// Gaussian along y with mean moving with x, last x bin left empty
+auto make_hist2d() -> std::unique_ptr<TH2D>
+{
+    auto hist = std::make_unique<TH2D>("h_slices", "", 20, 0, 20, 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int bx = 1; bx < 20; ++bx)
+    {
+        const auto mean = 3 + 0.2 * hist->GetXaxis()->GetBinCenter(bx);
+        for (int by = 1; by <= 100; ++by)
+        {
+            const auto y = hist->GetYaxis()->GetBinCenter(by);
+            const auto content = std::round(1000. * std::exp(-0.5 * (y - mean) * (y - mean) / 0.25));
+            hist->SetBinContent(bx, by, content);
+            hist->SetBinError(bx, by, std::sqrt(content));
+        }
+    }
+    return hist;
+}
+} // namespace
+
+TEST(TestsSlices, FitSlicesY)
+{
+    auto hist = make_hist2d();
+
+    hf::entry hfp(0, 10);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 3.2);
+    hfp.set_param(2, 0.6);
+
+    hf::fitter fitter;
+    const auto result = fitter.fit_slices(hist.get(), hf::fitter::slice_axis::y, hfp, "BQ", 4);
+
+    ASSERT_EQ(result.slices(), 20u);
+    ASSERT_EQ(result.values.size(), 3u);
+    for (size_t i = 0; i < 19; ++i)
+    {
+        ASSERT_EQ(result.status[i], 0) << "slice " << i;
+        ASSERT_NEAR(result.values[1][i], 3 + 0.2 * result.centers[i], 0.01) << "slice " << i;
+        ASSERT_NEAR(result.values[2][i], 0.5, 0.01) << "slice " << i;
+        ASSERT_GT(result.ndf[i], 0);
+    }
+    ASSERT_EQ(result.status[19], -1);
+
+    // the model entry is not modified
+    ASSERT_EQ(hfp.param(1).value, 3.2);
+
+    const auto graph = result.make_graph(1);
+    ASSERT_EQ(graph->GetN(), 19);
+    ASSERT_NEAR(graph->GetX()[0], 0.5, 1e-9);
+    ASSERT_NEAR(graph->GetY()[0], 3.1, 0.01);
+
+    ASSERT_THROW(result.make_graph(3), hf::index_error);
+}
+
+TEST(TestsSlices, SingleThreadMatches)
+{
+    auto hist = make_hist2d();
+
+    hf::entry hfp(0, 10);
+    hfp.add_function("gaus(0)");
+    hfp.set_param(0, 800);
+    hfp.set_param(1, 3.2);
+    hfp.set_param(2, 0.6);
+
+    hf::fitter fitter;
+    const auto serial = fitter.fit_slices(hist.get(), hf::fitter::slice_axis::y, hfp, "BQ", 1);
+    const auto parallel = fitter.fit_slices(hist.get(), hf::fitter::slice_axis::y, hfp, "BQ", 3);
+
+    for (size_t i = 0; i < serial.slices(); ++i)
+    {
+        ASSERT_EQ(serial.status[i], parallel.status[i]);
+        ASSERT_NEAR(serial.values[1][i], parallel.values[1][i], 1e-3);
+    }
+}
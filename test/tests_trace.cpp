@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "hellofitty.hpp"
+#include "hellofitty_config.h"
+
+#include "trace.hpp"
+
+#include <TH1.h>
+
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+auto read_file(const std::string& filename) -> std::string
+{
+    std::ifstream file(filename);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+} // namespace
+
+TEST(TestsTrace, ThreadBuffers)
+{
+    hf::detail::tracer trace;
+
+    const auto now = hf::detail::tracer::clock::now();
+    trace.complete("ignored", "test", now, now);
+    ASSERT_EQ(trace.size(), 0u);
+
+    trace.set_enabled(true);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&trace]
+            {
+                for (int i = 0; i < 100; ++i)
+                {
+                    hf::detail::trace_span span(&trace, "work", "test", "quote\"d");
+                }
+            });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    ASSERT_EQ(trace.size(), 400u);
+
+    const auto filename = tests_bin_path + "trace_threads.json";
+    ASSERT_TRUE(trace.write(filename));
+
+    const auto content = read_file(filename);
+    ASSERT_EQ(content.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    ASSERT_NE(content.find("quote\\\"d"), std::string::npos);
+
+    // one thread name metadata event per thread
+    size_t pos = 0, names = 0;
+    while ((pos = content.find("\"thread_name\"", pos)) != std::string::npos)
+    {
+        ++names;
+        ++pos;
+    }
+    ASSERT_EQ(names, 4u);
+
+    trace.clear();
+    ASSERT_EQ(trace.size(), 0u);
+}
+
+TEST(TestsTrace, FitterSpans)
+{
+    const auto input = tests_bin_path + "trace_input.txt";
+    const auto output = tests_bin_path + "trace_output.txt";
+    {
+        std::ofstream file(input);
+        file << " h_trace\t2 8 0 gaus(0) | 800 4.8 0.7\n";
+    }
+
+    auto hist = std::make_unique<TH1D>("h_trace", "", 100, 0, 10);
+    hist->SetDirectory(nullptr);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const auto x = hist->GetBinCenter(i);
+        hist->SetBinContent(i, std::round(1000. * std::exp(-0.5 * (x - 5.) * (x - 5.) / 0.25)));
+        hist->SetBinError(i, std::sqrt(hist->GetBinContent(i)));
+    }
+
+    hf::fitter fitter;
+    fitter.set_trace(true);
+    ASSERT_TRUE(fitter.init_from_file(input, output, hf::fitter::priority_mode::reference));
+    ASSERT_TRUE(fitter.fit(hist.get()).first);
+    ASSERT_TRUE(fitter.export_to_file());
+
+    const auto filename = tests_bin_path + "trace_fitter.json";
+    ASSERT_TRUE(fitter.write_trace(filename));
+
+    const auto content = read_file(filename);
+    for (const auto* span : {"\"import\"", "\"compile\"", "\"fit\"", "\"prepare\"", "\"minimize\"", "\"qa\"",
+                             "\"clone\"", "\"export\""})
+    {
+        ASSERT_NE(content.find(span), std::string::npos) << span;
+    }
+    ASSERT_NE(content.find("\"args\":{\"name\":\"h_trace\"}"), std::string::npos);
+}
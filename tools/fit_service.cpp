@@ -0,0 +1,117 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Resident fit service: loads the parameter file once and answers the fit requests sent with hf::service_client over
+/// a Unix domain socket until interrupted.
+
+#include "hellofitty.hpp"
+#include "hellofitty_service.hpp"
+
+#include <fmt/core.h>
+
+#include <getopt.h>
+
+#include <csignal>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+
+hf::service* running_service = nullptr;
+
+auto usage(const char* name) -> void
+{
+    fmt::print(stderr,
+               "Usage: {} [options] PARAMS_FILE\n"
+               "  -s, --socket PATH       socket path (default: hellofitty.sock)\n"
+               "  -v, --verbose           print the fits\n"
+               "Serves fits of the PARAMS_FILE entries until SIGINT or SIGTERM.\n",
+               name);
+}
+
+auto handle_signal(int /*signal*/) -> void
+{
+    if (running_service) { running_service->stop(); }
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    std::string socket_path = "hellofitty.sock";
+    bool verbose = false;
+
+    static const option long_options[] = {{"socket", required_argument, nullptr, 's'},
+                                          {"verbose", no_argument, nullptr, 'v'},
+                                          {"help", no_argument, nullptr, 'h'},
+                                          {nullptr, 0, nullptr, 0}};
+
+    int c = 0;
+    while ((c = getopt_long(argc, argv, "s:vh", long_options, nullptr)) != -1)
+    {
+        switch (c)
+        {
+            case 's':
+                socket_path = optarg;
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                usage(argv[0]);
+                return c == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (optind + 1 != argc)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    hf::fitter fitter;
+    fitter.set_verbose(verbose);
+    if (!fitter.init_from_file(argv[optind]))
+    {
+        fmt::print(stderr, "Could not load parameters from {:s}\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    hf::service service(fitter);
+    try
+    {
+        service.listen(socket_path);
+    }
+    catch (const std::runtime_error& e)
+    {
+        fmt::print(stderr, "{:s}\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    running_service = &service;
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    fmt::print("Serving {:s} on {:s}\n", argv[optind], socket_path);
+    service.run();
+    fmt::print("Served {:d} requests\n", service.get_requests_count());
+
+    running_service = nullptr;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,404 @@
+/*
+    HelloFitty - a versatile histogram fitting tool for ROOT-based projects
+    Copyright (C) 2015-2023  Rafał Lalik <rafallalik@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Writes deterministic workloads for benchmarking: a ROOT file with N histograms of signal peaks over background and
+/// the matching parameter files in v1 and v2 formats. The same seed always produces the same output.
+
+#include "hellofitty.hpp"
+
+#include <TFile.h>
+#include <TH1.h>
+#include <TRandom3.h>
+
+#include <fmt/core.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+enum class background_shape
+{
+    none,
+    expo,
+    pol1,
+    pol2
+};
+
+struct workload_config
+{
+    long histograms{100};
+    int bins_min{100};
+    int bins_max{100};
+    int peaks{1};
+    background_shape background{background_shape::expo};
+    double disabled_fraction{0.0};
+    double generic_fraction{0.0};
+    unsigned int seed{4357};
+    std::string output{"workload"};
+};
+
+struct shape_params
+{
+    std::vector<double> signal; // triplets of amplitude, mean, sigma
+    std::vector<double> background;
+};
+
+constexpr double range_min = 0.0;
+constexpr double range_max = 10.0;
+
+auto usage(const char* name) -> void
+{
+    fmt::print(stderr,
+               "Usage: {} [options]\n"
+               "  -n, --histograms N      number of histograms (default: 100)\n"
+               "  -b, --bins N[:M]        bins per histogram, or random in range N..M (default: 100)\n"
+               "  -p, --peaks N           number of gaussian peaks per histogram (default: 1)\n"
+               "  -g, --background NAME   background shape: none, expo, pol1, pol2 (default: expo)\n"
+               "  -d, --disabled F        fraction of disabled (@) entries (default: 0)\n"
+               "  -f, --generic F         fraction of histograms left for the generic entry (default: 0)\n"
+               "  -s, --seed N            random generator seed (default: 4357)\n"
+               "  -o, --output PREFIX     output files prefix (default: workload)\n"
+               "Writes PREFIX.root, PREFIX_v1.txt, PREFIX_v2.txt and PREFIX_generic.txt. The v1 file is skipped\n"
+               "without peaks or background, v1 entries need both a signal and a background function.\n",
+               name);
+}
+
+auto parse_background(const std::string& name) -> background_shape
+{
+    if (name == "none") return background_shape::none;
+    if (name == "expo") return background_shape::expo;
+    if (name == "pol1") return background_shape::pol1;
+    if (name == "pol2") return background_shape::pol2;
+
+    fmt::print(stderr, "Unknown background shape: {:s}\n", name);
+    std::exit(EXIT_FAILURE);
+}
+
+/// Short option of the long one, 0 if unknown.
+auto short_option(const std::string& name) -> char
+{
+    static const std::pair<const char*, char> long_options[] = {
+        {"histograms", 'n'}, {"bins", 'b'}, {"peaks", 'p'}, {"background", 'g'}, {"disabled", 'd'},
+        {"generic", 'f'},    {"seed", 's'}, {"output", 'o'}, {"help", 'h'}};
+
+    for (const auto& opt : long_options)
+    {
+        if (name == opt.first) { return opt.second; }
+    }
+    return 0;
+}
+
+auto parse_args(int argc, char* argv[]) -> workload_config
+{
+    workload_config cfg;
+
+    // parsed by hand, getopt is not available on all platforms: -n N, --histograms N or --histograms=N
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        char c = 0;
+        std::string value;
+        auto has_value = false;
+        if (arg.size() > 2 and arg.compare(0, 2, "--") == 0)
+        {
+            const auto eq = arg.find('=');
+            c = short_option(arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2));
+            if (eq != std::string::npos)
+            {
+                value = arg.substr(eq + 1);
+                has_value = true;
+            }
+        }
+        else if (arg.size() == 2 and arg[0] == '-') { c = arg[1]; }
+
+        if (c == 0 or c == 'h' or (!has_value and i + 1 == argc))
+        {
+            usage(argv[0]);
+            std::exit(c == 'h' ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        if (!has_value) { value = argv[++i]; }
+
+        try
+        {
+            switch (c)
+            {
+                case 'n':
+                    cfg.histograms = std::stol(value);
+                    break;
+                case 'b':
+                {
+                    const auto sep = value.find(':');
+                    cfg.bins_min = std::stoi(value.substr(0, sep));
+                    cfg.bins_max = sep == std::string::npos ? cfg.bins_min : std::stoi(value.substr(sep + 1));
+                    break;
+                }
+                case 'p':
+                    cfg.peaks = std::stoi(value);
+                    break;
+                case 'g':
+                    cfg.background = parse_background(value);
+                    break;
+                case 'd':
+                    cfg.disabled_fraction = std::stod(value);
+                    break;
+                case 'f':
+                    cfg.generic_fraction = std::stod(value);
+                    break;
+                case 's':
+                    cfg.seed = static_cast<unsigned int>(std::stoul(value));
+                    break;
+                case 'o':
+                    cfg.output = value;
+                    break;
+                default:
+                    usage(argv[0]);
+                    std::exit(EXIT_FAILURE);
+            }
+        }
+        catch (const std::logic_error&)
+        {
+            fmt::print(stderr, "Invalid value of {:s}: {:s}\n", arg, value);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    // at least one function is needed to fit
+    if (cfg.histograms < 1 or cfg.bins_min < 1 or cfg.bins_max < cfg.bins_min or cfg.peaks < 0 or
+        (cfg.peaks == 0 and cfg.background == background_shape::none))
+    {
+        usage(argv[0]);
+        std::exit(EXIT_FAILURE);
+    }
+
+    return cfg;
+}
+
+auto background_formula(background_shape shape, int first_param) -> std::string
+{
+    switch (shape)
+    {
+        case background_shape::expo:
+            return fmt::format("expo({:d})", first_param);
+        case background_shape::pol1:
+            return fmt::format("pol1({:d})", first_param);
+        case background_shape::pol2:
+            return fmt::format("pol2({:d})", first_param);
+        case background_shape::none:
+        default:
+            return {};
+    }
+}
+
+auto background_value(background_shape shape, const std::vector<double>& pars, double x) -> double
+{
+    switch (shape)
+    {
+        case background_shape::expo:
+            return std::exp(pars[0] + pars[1] * x);
+        case background_shape::pol1:
+            return pars[0] + pars[1] * x;
+        case background_shape::pol2:
+            return pars[0] + pars[1] * x + pars[2] * x * x;
+        case background_shape::none:
+        default:
+            return 0.0;
+    }
+}
+
+auto draw_bins(const workload_config& cfg, TRandom3& rng) -> int
+{
+    if (cfg.bins_min == cfg.bins_max) { return cfg.bins_min; }
+    return cfg.bins_min + static_cast<int>(rng.Integer(static_cast<UInt_t>(cfg.bins_max - cfg.bins_min + 1)));
+}
+
+/// Draw true shape parameters, background stays positive over the whole range.
+auto draw_shape(const workload_config& cfg, TRandom3& rng, int bins) -> shape_params
+{
+    shape_params shape;
+
+    const auto scale = 100.0 * 100.0 / bins; // keeps total statistics independent of binning
+    for (int i = 0; i < cfg.peaks; ++i)
+    {
+        shape.signal.push_back(scale * rng.Uniform(5, 50));
+        shape.signal.push_back(rng.Uniform(range_min + 1, range_max - 1));
+        shape.signal.push_back(rng.Uniform(0.1, 0.8));
+    }
+
+    switch (cfg.background)
+    {
+        case background_shape::expo:
+            shape.background = {std::log(scale * rng.Uniform(1, 10)), -rng.Uniform(0.1, 0.5)};
+            break;
+        case background_shape::pol1:
+            shape.background = {scale * rng.Uniform(5, 10), -scale * rng.Uniform(0, 0.4)};
+            break;
+        case background_shape::pol2:
+        {
+            // a parabola with its minimum, which is positive, at x0 or beyond the range
+            const auto curvature = scale * rng.Uniform(0, 0.05);
+            const auto x0 = rng.Uniform(range_min, range_max + 5);
+            const auto minimum = scale * rng.Uniform(1, 5);
+            shape.background = {curvature * x0 * x0 + minimum, -2 * curvature * x0, curvature};
+            break;
+        }
+        case background_shape::none:
+            break;
+    }
+
+    return shape;
+}
+
+auto make_histogram(const std::string& name, const workload_config& cfg, const shape_params& shape, TRandom3& rng,
+                    int bins) -> std::unique_ptr<TH1D>
+{
+    auto hist = std::make_unique<TH1D>(name.c_str(), "", bins, range_min, range_max);
+    hist->SetDirectory(nullptr);
+
+    for (int bin = 1; bin <= bins; ++bin)
+    {
+        const auto x = hist->GetBinCenter(bin);
+
+        auto expected = std::max(background_value(cfg.background, shape.background, x), 0.0);
+        for (size_t i = 0; i < shape.signal.size(); i += 3)
+        {
+            const auto z = (x - shape.signal[i + 1]) / shape.signal[i + 2];
+            expected += shape.signal[i] * std::exp(-0.5 * z * z);
+        }
+
+        const auto content = rng.Poisson(expected);
+        hist->SetBinContent(bin, content);
+        hist->SetBinError(bin, std::sqrt(content));
+    }
+
+    return hist;
+}
+
+/// Build the fit entry, starting values are the true values smeared by 10%.
+auto make_entry(const workload_config& cfg, const shape_params& shape, TRandom3& rng) -> hf::entry
+{
+    hf::entry hfp(range_min, range_max);
+
+    std::string signal;
+    for (int i = 0; i < cfg.peaks; ++i)
+        signal += fmt::format("{:s}gaus({:d})", i ? "+" : "", 3 * i);
+    if (!signal.empty()) { hfp.add_function(signal); }
+
+    const auto bkg = background_formula(cfg.background, 3 * cfg.peaks);
+    if (!bkg.empty()) { hfp.add_function(bkg); }
+
+    int par = 0;
+    for (const auto value : shape.signal)
+        hfp.set_param(par++, value * rng.Uniform(0.9, 1.1));
+    for (const auto value : shape.background)
+        hfp.set_param(par++, value * rng.Uniform(0.9, 1.1));
+
+    return hfp;
+}
+
+/// The v1 format stores exactly one signal and one background function.
+auto has_v1_format(const workload_config& cfg) -> bool
+{
+    return cfg.peaks > 0 and cfg.background != background_shape::none;
+}
+
+/// Format the entry line, marking the disabled ones.
+auto format_entry(const std::string& name, const hf::entry& hfp, hf::format_version version, bool disabled)
+    -> std::string
+{
+    auto line = hf::tools::format_line_entry(name, &hfp, version);
+    if (disabled) { line[0] = '@'; }
+    return line;
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    const auto cfg = parse_args(argc, argv);
+
+    TRandom3 rng(cfg.seed);
+
+    const auto root_name = cfg.output + ".root";
+    std::unique_ptr<TFile> file(TFile::Open(root_name.c_str(), "RECREATE"));
+    if (!file or file->IsZombie())
+    {
+        fmt::print(stderr, "File {:s} not open\n", root_name);
+        return EXIT_FAILURE;
+    }
+
+    const auto write_v1 = has_v1_format(cfg);
+    std::ofstream v1_file;
+    if (write_v1) { v1_file.open(cfg.output + "_v1.txt"); }
+    std::ofstream v2_file(cfg.output + "_v2.txt");
+    std::ofstream generic_file(cfg.output + "_generic.txt");
+    if ((write_v1 and !v1_file.is_open()) or !v2_file.is_open() or !generic_file.is_open())
+    {
+        fmt::print(stderr, "Parameter files {:s}_*.txt can't be created\n", cfg.output);
+        return EXIT_FAILURE;
+    }
+
+    long disabled = 0;
+    long generic = 0;
+
+    for (long i = 0; i < cfg.histograms; ++i)
+    {
+        const auto name = fmt::format("hist_{:d}", i);
+        const auto bins = draw_bins(cfg, rng);
+
+        const auto shape = draw_shape(cfg, rng, bins);
+        auto hist = make_histogram(name, cfg, shape, rng, bins);
+        file->WriteTObject(hist.get());
+
+        // always draw to keep the sequence independent of the fractions
+        const auto entry = make_entry(cfg, shape, rng);
+        const auto is_generic = rng.Rndm() < cfg.generic_fraction;
+        const auto is_disabled = rng.Rndm() < cfg.disabled_fraction;
+
+        if (is_generic)
+        {
+            ++generic;
+            continue; // histogram without own entry falls back to the generic entry
+        }
+        disabled += is_disabled;
+
+        if (write_v1) { v1_file << format_entry(name, entry, hf::format_version::v1, is_disabled) << '\n'; }
+        v2_file << format_entry(name, entry, hf::format_version::v2, is_disabled) << '\n';
+    }
+
+    // generic entry uses own generator, so it does not depend on the number of histograms
+    TRandom3 generic_rng(cfg.seed);
+    const auto generic_shape = draw_shape(cfg, generic_rng, (cfg.bins_min + cfg.bins_max) / 2);
+    const auto generic_entry = make_entry(cfg, generic_shape, generic_rng);
+    generic_file << format_entry("generic", generic_entry, hf::format_version::v2, false) << '\n';
+
+    file->Close();
+
+    fmt::print("Written {:d} histograms to {:s}, {:d} entries ({:d} disabled), {:d} left for the generic entry\n",
+               cfg.histograms, root_name, cfg.histograms - generic, disabled, generic);
+    if (!write_v1) { fmt::print("File {:s}_v1.txt not written, v1 needs a signal and a background\n", cfg.output); }
+
+    return EXIT_SUCCESS;
+}